@@ -0,0 +1,948 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#include "../src/lexical/Scanner/Scanner.h"
+#include "../src/lexical/Scanner/SimdScan.h"
+#include "../src/lexical/Scanner/TokenPipeline.h"
+#include "../src/parser/LL1/PredictiveParser.h"
+#include "../src/parser/LL1/StaticLL1Table.h"
+#include "../src/parser/LR/ShiftReduceParser.h"
+#include "../src/parser/Parser.h"
+
+// Benchmarks dos pedidos de desempenho, um cenario por pedido. Cada cenario
+// gera o proprio corpus (deterministico, do tamanho de --size) e imprime o
+// melhor de --runs execucoes. Uso: bench/run.sh [--runs N] [--size MB]
+// [cenario ...]; sem cenarios roda todos, --list lista.
+
+namespace
+{
+    struct Options
+    {
+        int runs = 5;
+        size_t bytes = 32 * 1024 * 1024;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Menor tempo de runs execucoes de work
+    template <typename Work>
+    double bestOf(int runs, const Work &work)
+    {
+        double best = 1e300;
+        for (int run = 0; run < runs; run++)
+        {
+            Clock::time_point start = Clock::now();
+            work();
+            best = std::min(best, secondsSince(start));
+        }
+        return best;
+    }
+
+    void row(const std::string &what, double value, const char *unit)
+    {
+        std::printf("  %-46s %12.3f %s\n", what.c_str(), value, unit);
+    }
+
+    double megabytes(size_t bytes)
+    {
+        return bytes / (1024.0 * 1024.0);
+    }
+
+    // Programa aceito pelos tres analisadores, com espaco entre os tokens (o
+    // Scanner engole o caractere depois de um delimitador). Com
+    // statementsPerProcedure > 0 o texto e quase todo procedimentos desse
+    // tamanho; senao, um corpo principal so.
+    class ProgramGenerator
+    {
+    public:
+        explicit ProgramGenerator(uint32_t seed) : random(seed) {}
+
+        std::string generate(size_t bytes, size_t statementsPerProcedure)
+        {
+            std::string text = "program gerado ;\nvar x , y , contador_total : integer ;\n"
+                               "    z , media : real ;\n    achou : boolean ;\n";
+            text.reserve(bytes + 4096);
+            if (statementsPerProcedure > 0)
+            {
+                for (size_t procedure = 0; text.size() < bytes; procedure++)
+                {
+                    text += "procedure p" + std::to_string(procedure) + " ;\nvar local , x : integer ;\nbegin\n";
+                    statements(text, statementsPerProcedure);
+                    text += "\nend ;\n";
+                }
+                text += "begin\n";
+                statements(text, 8);
+            }
+            else
+            {
+                text += "begin\n";
+                while (text.size() < bytes)
+                {
+                    statements(text, 64);
+                    text += " ;\n";
+                }
+                statements(text, 1);
+            }
+            text += "\nend .\n";
+            return text;
+        }
+
+    private:
+        std::mt19937 random;
+
+        size_t pick(size_t count) { return random() % count; }
+        const char *variable()
+        {
+            static const char *const NAMES[] = {"x", "y", "z", "contador_total", "media", "local", "achou"};
+            return NAMES[pick(7)];
+        }
+
+        void statements(std::string &text, size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                if (i > 0)
+                {
+                    text += " ;\n";
+                }
+                text += "    ";
+                statement(text);
+            }
+        }
+
+        void statement(std::string &text)
+        {
+            switch (pick(10))
+            {
+            case 0:
+                text += "if ";
+                relation(text);
+                text += " then ";
+                assignment(text);
+                text += " else ";
+                assignment(text);
+                break;
+            case 1:
+                text += "while ";
+                relation(text);
+                text += " do begin ";
+                assignment(text);
+                text += " ; ";
+                assignment(text);
+                text += " end";
+                break;
+            case 2:
+                text += "escreve ( ";
+                expression(text, 2);
+                text += " , ";
+                expression(text, 2);
+                text += " )";
+                break;
+            case 3:
+                text += "# comentario ate o fim da linha\n    ";
+                assignment(text);
+                break;
+            default:
+                assignment(text);
+                break;
+            }
+        }
+
+        void assignment(std::string &text)
+        {
+            text += variable();
+            text += " := ";
+            expression(text, 3);
+        }
+
+        void relation(std::string &text)
+        {
+            static const char *const RELATIONS[] = {" < ", " <= ", " > ", " >= ", " <> "};
+            expression(text, 2);
+            text += RELATIONS[pick(5)];
+            expression(text, 2);
+        }
+
+        void expression(std::string &text, int depth)
+        {
+            static const char *const ADDITIVE[] = {" + ", " - ", " or "};
+            size_t terms = 1 + pick(3);
+            for (size_t i = 0; i < terms; i++)
+            {
+                if (i > 0)
+                {
+                    text += ADDITIVE[pick(3)];
+                }
+                term(text, depth);
+            }
+        }
+
+        void term(std::string &text, int depth)
+        {
+            static const char *const MULTIPLICATIVE[] = {" * ", " / ", " and "};
+            size_t factors = 1 + pick(2);
+            for (size_t i = 0; i < factors; i++)
+            {
+                if (i > 0)
+                {
+                    text += MULTIPLICATIVE[pick(3)];
+                }
+                factor(text, depth);
+            }
+        }
+
+        void factor(std::string &text, int depth)
+        {
+            switch (depth > 0 ? pick(8) : pick(3))
+            {
+            case 0:
+                text += variable();
+                break;
+            case 1:
+                text += std::to_string(pick(1000));
+                break;
+            case 2:
+                text += std::to_string(pick(100)) + "." + std::to_string(pick(100));
+                break;
+            case 3:
+                text += "( ";
+                expression(text, depth - 1);
+                text += " )";
+                break;
+            case 4:
+                text += "f ( ";
+                expression(text, depth - 1);
+                text += " , ";
+                expression(text, depth - 1);
+                text += " )";
+                break;
+            case 5:
+                text += "not ";
+                factor(text, depth - 1);
+                break;
+            default:
+                text += variable();
+                break;
+            }
+        }
+    };
+
+    // Identificadores e palavras reservadas (nas duas grafias de and/or), so
+    // separados por espaco e quebras de linha
+    std::string identifierCorpus(size_t bytes, uint32_t seed)
+    {
+        static const char *const WORDS[] = {"contador_total", "x", "valor_intermediario_2", "begin", "end", "if",
+                                            "then", "else", "while", "do", "not", "and", "AND", "or", "OR",
+                                            "program", "procedure", "integer", "real", "boolean", "var",
+                                            "indice", "nome_bem_mais_comprido_que_dezesseis", "ab", "programa",
+                                            "ends", "iff", "Begin", "resultado", "q"};
+        std::mt19937 random(seed);
+        std::string text;
+        text.reserve(bytes + 64);
+        for (size_t word = 1; text.size() < bytes; word++)
+        {
+            text += WORDS[random() % (sizeof(WORDS) / sizeof(WORDS[0]))];
+            text += word % 12 == 0 ? '\n' : ' ';
+        }
+        return text;
+    }
+
+    // Comentarios de linha longos e recuos, com um comando curto a cada tanto
+    std::string commentCorpus(size_t bytes)
+    {
+        std::string text;
+        text.reserve(bytes + 256);
+        for (size_t line = 0; text.size() < bytes; line++)
+        {
+            text += line % 4 == 0 ? "        x := y + 1 ;\n" : "";
+            text += std::string(4 + line % 13, ' ');
+            text += "# comentario numero " + std::to_string(line) +
+                    " explicando o trecho seguinte com bastante texto para pular\n";
+        }
+        return text;
+    }
+
+    std::vector<std::string_view> words(const std::string &text)
+    {
+        std::vector<std::string_view> result;
+        size_t start = 0;
+        for (size_t i = 0; i <= text.size(); i++)
+        {
+            if (i == text.size() || text[i] == ' ' || text[i] == '\n')
+            {
+                if (i > start)
+                {
+                    result.emplace_back(text.data() + start, i - start);
+                }
+                start = i + 1;
+            }
+        }
+        return result;
+    }
+
+    // Impede que o compilador descarte o trabalho medido
+    volatile size_t sink;
+
+    void writeFile(const std::string &path, const std::string &text)
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    // Roda work num processo filho e devolve o tempo que ele mede e o pico de
+    // RSS do filho, sem o que o pai ja tinha alocado
+    struct ChildResult
+    {
+        double seconds;
+        long peakKilobytes;
+    };
+
+    template <typename Work>
+    ChildResult inChild(const Work &work)
+    {
+        int channel[2];
+        if (pipe(channel) != 0)
+        {
+            std::perror("pipe");
+            std::exit(1);
+        }
+        std::fflush(stdout);
+        pid_t child = fork();
+        if (child == 0)
+        {
+            close(channel[0]);
+            double seconds = work();
+            ssize_t written = write(channel[1], &seconds, sizeof(seconds));
+            _exit(written == sizeof(seconds) ? 0 : 1);
+        }
+        close(channel[1]);
+        ChildResult result{0, 0};
+        if (read(channel[0], &result.seconds, sizeof(result.seconds)) != sizeof(result.seconds))
+        {
+            result.seconds = -1;
+        }
+        close(channel[0]);
+        int status;
+        struct rusage usage;
+        wait4(child, &status, 0, &usage);
+        result.peakKilobytes = usage.ru_maxrss;
+        return result;
+    }
+
+    // user-001: mmap contra leitura para um buffer proprio e contra o
+    // construtor original (ifstream para std::string, copiada para um
+    // std::vector<char>). Primeiro token e pico de RSS lexando o arquivo todo
+    // com nextToken, sem TokenBuffer, num processo novo por medida.
+    void benchStartup(const Options &options)
+    {
+        const std::string path = "build/bench/startup.mc";
+        {
+            std::string text = ProgramGenerator(1).generate(options.bytes, 0);
+            writeFile(path, text);
+            std::printf("  %.1f MB file\n", megabytes(text.size()));
+        }
+
+        enum class Load
+        {
+            MMAP,
+            READ,
+            IFSTREAM_COPY,
+        };
+        auto lexFile = [&](Load load) {
+            return [&path, load]() {
+                Clock::time_point start = Clock::now();
+                std::vector<char> copy;
+                SourceBuffer source;
+                if (load == Load::IFSTREAM_COPY)
+                {
+                    std::ifstream file(path, std::ios::binary);
+                    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+                    copy.assign(content.begin(), content.end());
+                    source = SourceBuffer::view(copy.data(), copy.size());
+                }
+                else
+                {
+                    source = SourceBuffer::fromFile(path, load == Load::MMAP);
+                }
+                Scanner scanner(std::move(source));
+                scanner.nextToken();
+                double firstToken = secondsSince(start);
+                while (scanner.nextToken().getType() != TokenType::NONE)
+                {
+                }
+                return firstToken;
+            };
+        };
+
+        // Aquece o cache de paginas e mede o processo sem trabalho
+        inChild(lexFile(Load::READ));
+        long emptyKilobytes = inChild([]() { return 0.0; }).peakKilobytes;
+        row("empty child process: peak RSS", emptyKilobytes / 1024.0, "MB");
+
+        const std::pair<Load, const char *> loads[] = {
+            {Load::MMAP, "mmap"}, {Load::READ, "read into owned buffer"}, {Load::IFSTREAM_COPY, "ifstream + copy (original)"}};
+        for (const auto &[load, name] : loads)
+        {
+            ChildResult best{1e300, 0};
+            for (int run = 0; run < options.runs; run++)
+            {
+                ChildResult result = inChild(lexFile(load));
+                best.seconds = std::min(best.seconds, result.seconds);
+                best.peakKilobytes = std::max(best.peakKilobytes, result.peakKilobytes);
+            }
+            row(std::string(name) + ": first token", best.seconds * 1e3, "ms");
+            row(std::string(name) + ": peak RSS", best.peakKilobytes / 1024.0, "MB");
+        }
+        std::remove(path.c_str());
+    }
+
+    // user-005: custo por token de reconhecer palavras reservadas num texto
+    // so de identificadores. classifyKeyword contra uma consulta a um
+    // unordered_map estatico e contra o codigo original, que remontava o mapa
+    // de 14 palavras a cada token antes de procurar (e depois comparava and/or).
+    void benchKeywords(const Options &options)
+    {
+        std::string text = identifierCorpus(options.bytes / 4, 5);
+        std::vector<std::string_view> lexemes = words(text);
+        std::printf("  %zu lexemes\n", lexemes.size());
+        auto perToken = [&](double seconds) { return seconds * 1e9 / lexemes.size(); };
+
+        double classify = bestOf(options.runs, [&]() {
+            size_t keywords = 0;
+            for (std::string_view lexeme : lexemes)
+            {
+                keywords += classifyKeyword(lexeme) != Keyword::NONE;
+            }
+            sink = keywords;
+        });
+        row("classifyKeyword", perToken(classify), "ns/token");
+
+        const std::unordered_map<std::string_view, Keyword> table = {
+            {"program", Keyword::PROGRAM}, {"var", Keyword::VAR},         {"integer", Keyword::INTEGER},
+            {"real", Keyword::REAL},       {"boolean", Keyword::BOOLEAN}, {"procedure", Keyword::PROCEDURE},
+            {"begin", Keyword::BEGIN},     {"end", Keyword::END},         {"if", Keyword::IF},
+            {"then", Keyword::THEN},       {"else", Keyword::ELSE},       {"while", Keyword::WHILE},
+            {"do", Keyword::DO},           {"not", Keyword::NOT},         {"and", Keyword::AND},
+            {"AND", Keyword::AND},         {"or", Keyword::OR},           {"OR", Keyword::OR},
+            {"true", Keyword::TRUE},       {"false", Keyword::FALSE}};
+        double lookup = bestOf(options.runs, [&]() {
+            size_t keywords = 0;
+            for (std::string_view lexeme : lexemes)
+            {
+                keywords += table.count(lexeme);
+            }
+            sink = keywords;
+        });
+        row("static unordered_map lookup", perToken(lookup), "ns/token");
+
+        std::unordered_map<std::string, std::string> reservedWords;
+        double original = bestOf(std::max(1, options.runs / 2), [&]() {
+            size_t keywords = 0;
+            for (std::string_view lexeme : lexemes)
+            {
+                reservedWords = {{"program", "program"}, {"var", "var"},     {"integer", "integer"},
+                                 {"real", "real"},       {"boolean", "boolean"}, {"procedure", "procedure"},
+                                 {"begin", "begin"},     {"end", "end"},     {"if", "if"},
+                                 {"then", "then"},       {"else", "else"},   {"while", "while"},
+                                 {"do", "do"},           {"not", "not"}};
+                std::string content(lexeme);
+                if (reservedWords.find(content) != reservedWords.end())
+                {
+                    keywords++;
+                }
+                else if (content == "AND" || content == "and" || content == "OR" || content == "or")
+                {
+                    keywords++;
+                }
+            }
+            sink = keywords;
+        });
+        row("original: map rebuilt per token", perToken(original), "ns/token");
+    }
+
+    double lexSeconds(const std::string &text, ScannerEngine engine, int runs, bool recovery = false)
+    {
+        return bestOf(runs, [&]() {
+            Scanner scanner(SourceBuffer::view(text.data(), text.size()));
+            scanner.setEngine(engine);
+            scanner.setParallelLexing(SIZE_MAX);
+            scanner.setErrorRecovery(recovery);
+            sink = scanner.tokenizeAll().size();
+        });
+    }
+
+    // user-007: vazao do Scanner (uma thread, tokenizeAll) em corpora de
+    // comentarios e de identificadores, com cada implementacao das varreduras
+    // em bloco que a CPU suporta e nos dois motores
+    void benchSimd(const Options &options)
+    {
+        const std::pair<const char *, std::string> corpora[] = {{"comment-heavy", commentCorpus(options.bytes)},
+                                                                {"identifier-heavy", identifierCorpus(options.bytes, 7)}};
+        const char *chosen = simdScanLevel();
+        for (const char *level : {"avx2", "sse2", "scalar"})
+        {
+            if (!setSimdScanLevel(level))
+            {
+                continue;
+            }
+            for (const auto &[name, text] : corpora)
+            {
+                for (ScannerEngine engine : {ScannerEngine::SWITCH, ScannerEngine::TABLE})
+                {
+                    double seconds = lexSeconds(text, engine, options.runs);
+                    row(std::string(level) + ", " + name + ", " + (engine == ScannerEngine::TABLE ? "table" : "switch"),
+                        megabytes(text.size()) / seconds, "MB/s");
+                }
+            }
+        }
+        setSimdScanLevel(chosen);
+    }
+
+    // user-008: o mesmo programa em linhas normais e numa linha so de varios
+    // MB. Sem contabilidade de linha/coluna por byte, a vazao nao pode cair
+    // na linha unica; locate() monta o indice de linhas na primeira consulta.
+    void benchOneLine(const Options &options)
+    {
+        std::string lines = ProgramGenerator(3).generate(options.bytes, 0);
+        const std::string comment = "# comentario ate o fim da linha\n";
+        for (size_t at = lines.find(comment); at != std::string::npos; at = lines.find(comment, at))
+        {
+            lines.erase(at, comment.size());
+        }
+        std::string oneLine = lines;
+        std::replace(oneLine.begin(), oneLine.end(), '\n', ' ');
+        std::printf("  %.1f MB, %zu lines vs 1 line\n", megabytes(lines.size()),
+                    static_cast<size_t>(std::count(lines.begin(), lines.end(), '\n')));
+
+        for (ScannerEngine engine : {ScannerEngine::SWITCH, ScannerEngine::TABLE})
+        {
+            const char *name = engine == ScannerEngine::TABLE ? "table" : "switch";
+            row(std::string(name) + ", many lines", megabytes(lines.size()) / lexSeconds(lines, engine, options.runs),
+                "MB/s");
+            row(std::string(name) + ", one line", megabytes(oneLine.size()) / lexSeconds(oneLine, engine, options.runs),
+                "MB/s");
+        }
+        for (const auto &[name, text] : {std::pair<const char *, const std::string &>{"many lines", lines},
+                                         std::pair<const char *, const std::string &>{"one line", oneLine}})
+        {
+            Scanner scanner(SourceBuffer::view(text.data(), text.size()));
+            Clock::time_point start = Clock::now();
+            SourceLocation first = scanner.locate(text.size());
+            double build = secondsSince(start);
+            start = Clock::now();
+            SourceLocation second = scanner.locate(text.size() / 2);
+            double lookup = secondsSince(start);
+            sink = first.col + second.col;
+            row(std::string("locate, ") + name + ": first call (builds index)", build * 1e3, "ms");
+            row(std::string("locate, ") + name + ": next call", lookup * 1e6, "us");
+        }
+    }
+
+    // user-012: o modo recovery nao pode custar nada em texto limpo; num texto
+    // cheio de erros o custo e o dos diagnosticos, um por simbolo proibido
+    void benchRecovery(const Options &options)
+    {
+        std::string clean = ProgramGenerator(5).generate(options.bytes, 0);
+        std::string dirty;
+        dirty.reserve(clean.size() + clean.size() / 32);
+        for (size_t at = 0; at < clean.size(); at++)
+        {
+            dirty += clean[at];
+            if (at % 128 == 127 && clean[at] == ' ')
+            {
+                dirty += "@ ";
+            }
+        }
+        Scanner counter(SourceBuffer::view(dirty.data(), dirty.size()));
+        counter.setErrorRecovery(true);
+        TokenBuffer tokens = counter.tokenizeAll();
+        std::printf("  %.1f MB clean; error-dense copy has %zu diagnostics in %zu tokens\n",
+                    megabytes(clean.size()), counter.getDiagnostics().size(), tokens.size());
+
+        for (ScannerEngine engine : {ScannerEngine::SWITCH, ScannerEngine::TABLE})
+        {
+            std::string name = engine == ScannerEngine::TABLE ? "table" : "switch";
+            row(name + ", clean, recovery off", megabytes(clean.size()) / lexSeconds(clean, engine, options.runs),
+                "MB/s");
+            row(name + ", clean, recovery on",
+                megabytes(clean.size()) / lexSeconds(clean, engine, options.runs, true), "MB/s");
+            row(name + ", error-dense, recovery on",
+                megabytes(dirty.size()) / lexSeconds(dirty, engine, options.runs, true), "MB/s");
+        }
+    }
+
+    TokenBuffer lexAll(const std::string &text)
+    {
+        Scanner scanner(SourceBuffer::view(text.data(), text.size()));
+        scanner.setParallelLexing(SIZE_MAX);
+        return scanner.tokenizeAll();
+    }
+
+    // Parse sequencial (com a AST) de tokens ja lexados; a Ast e reaproveitada
+    double parseSeconds(const TokenBuffer &tokens, Ast &ast, int runs, size_t errorLimit = 25)
+    {
+        return bestOf(runs, [&]() {
+            ast.clear();
+            TokenCursor cursor(tokens);
+            Parser parser(cursor, ast);
+            parser.setParallelParsing(SIZE_MAX);
+            parser.setErrorLimit(errorLimit);
+            parser.parseProgram();
+            sink = parser.getDiagnostics().size();
+        });
+    }
+
+    bool acceptedByParser(const TokenBuffer &tokens)
+    {
+        Ast ast;
+        TokenCursor cursor(tokens);
+        Parser parser(cursor, ast);
+        parser.setParallelParsing(SIZE_MAX);
+        return parser.parseProgram() != NO_NODE && parser.getDiagnostics().empty();
+    }
+
+    // user-016: custo do parser por token, a partir de tokens ja lexados,
+    // contra so percorrer os mesmos tokens com o TokenCursor
+    void benchParser(const Options &options)
+    {
+        std::string text = ProgramGenerator(11).generate(options.bytes, 0);
+        TokenBuffer tokens = lexAll(text);
+        double count = static_cast<double>(tokens.size());
+        std::printf("  %.1f MB, %zu tokens, accepted: %s\n", megabytes(text.size()), tokens.size(),
+                    acceptedByParser(tokens) ? "yes" : "NO");
+
+        double walk = bestOf(options.runs, [&]() {
+            TokenCursor cursor(tokens);
+            size_t keywords = 0;
+            for (Token token = cursor.next(); token.getType() != TokenType::NONE; token = cursor.next())
+            {
+                keywords += token.getKeyword() != Keyword::NONE;
+            }
+            sink = keywords;
+        });
+        Ast ast;
+        double parse = parseSeconds(tokens, ast, options.runs);
+        row("TokenCursor::next only", walk * 1e9 / count, "ns/token");
+        row("Parser::parseProgram", parse * 1e9 / count, "ns/token");
+        row("Parser::parseProgram", count / parse / 1e6, "Mtokens/s");
+    }
+
+    // user-017: tamanho da AST plana e custo de monta-la. A primeira passada
+    // usa uma Ast nova; as seguintes reaproveitam a capacidade depois de clear.
+    void benchAst(const Options &options)
+    {
+        for (size_t bytes : {options.bytes / 256, options.bytes})
+        {
+            std::string text = ProgramGenerator(13).generate(bytes, 0);
+            TokenBuffer tokens = lexAll(text);
+            std::printf("  %.2f MB, %zu tokens\n", megabytes(text.size()), tokens.size());
+
+            double fresh = bestOf(options.runs, [&]() {
+                Ast ast;
+                TokenCursor cursor(tokens);
+                Parser parser(cursor, ast);
+                parser.setParallelParsing(SIZE_MAX);
+                parser.parseProgram();
+                sink = ast.size();
+            });
+            Ast ast;
+            double reused = parseSeconds(tokens, ast, options.runs);
+            size_t nodes = ast.size();
+            size_t used = nodes * (sizeof(NodeKind) + sizeof(Operator) + 3 * sizeof(uint32_t)) +
+                          ast.extra.size() * sizeof(uint32_t);
+            // Uma vez so: de novo seria limpar uma Ast ja vazia
+            double clear = bestOf(1, [&]() { ast.clear(); });
+
+            std::printf("  %zu nodes (%.2f per token)\n", nodes, static_cast<double>(nodes) / tokens.size());
+            row("bytes/node used", static_cast<double>(used) / nodes, "B");
+            row("bytes/node reserved", static_cast<double>(ast.capacityBytes()) / nodes, "B");
+            row("parse, new Ast", fresh * 1e3, "ms");
+            row("parse, Ast reused after clear()", reused * 1e3, "ms");
+            row("Ast::clear", clear * 1e6, "us");
+        }
+    }
+
+    // user-018: o modo panico nao pode pesar no caminho sem erros, com qualquer
+    // limite; num texto com um erro de sintaxe a cada ~256 atribuicoes o parser
+    // segue ate o fim e lista todos
+    void benchErrors(const Options &options)
+    {
+        std::string clean = ProgramGenerator(17).generate(options.bytes, 0);
+        std::string broken;
+        broken.reserve(clean.size() + clean.size() / 256);
+        size_t assignments = 0;
+        for (size_t at = 0; at < clean.size();)
+        {
+            if (clean.compare(at, 4, " := ") == 0 && ++assignments % 256 == 0)
+            {
+                broken += " := * ";
+                at += 4;
+                continue;
+            }
+            broken += clean[at++];
+        }
+        TokenBuffer cleanTokens = lexAll(clean);
+        TokenBuffer brokenTokens = lexAll(broken);
+        std::printf("  %.1f MB, %zu tokens, accepted: %s; %zu errors injected\n", megabytes(clean.size()),
+                    cleanTokens.size(), acceptedByParser(cleanTokens) ? "yes" : "NO", assignments / 256);
+
+        Ast ast;
+        for (size_t limit : {size_t{1}, size_t{25}, SIZE_MAX})
+        {
+            std::string name = limit == SIZE_MAX ? "no limit" : "limit " + std::to_string(limit);
+            row("clean, " + name, parseSeconds(cleanTokens, ast, options.runs, limit) * 1e3, "ms");
+        }
+        double seconds = parseSeconds(brokenTokens, ast, options.runs, SIZE_MAX);
+        row("with errors, no limit (" + std::to_string(sink) + " diagnostics)", seconds * 1e3, "ms");
+        seconds = parseSeconds(brokenTokens, ast, options.runs, 25);
+        row("with errors, limit 25 (stops at the 25th)", seconds * 1e3, "ms");
+    }
+
+    // Programa com atribuicoes de terms termos cada, ate bytes
+    std::string longExpressions(size_t bytes, size_t terms)
+    {
+        static const char *const OPERATORS[] = {" + ", " * ", " - ", " / "};
+        std::string text = "program longas ;\nvar x , y : integer ;\nbegin\n";
+        text.reserve(bytes + 4096);
+        while (text.size() < bytes)
+        {
+            text += "    x := y";
+            for (size_t term = 1; term < terms; term++)
+            {
+                text += OPERATORS[term % 4];
+                text += term % 3 == 0 ? "( x - 1 )" : "y";
+            }
+            text += " ;\n";
+        }
+        text += "    x := 0\nend .\n";
+        return text;
+    }
+
+    // user-020/user-023: os analisadores preditivo (tabela constexpr) e
+    // LALR(1) contra o de descida recursiva, sobre os mesmos tokens, e o custo
+    // de gerar as tabelas de getGramatica() em tempo de execucao
+    void benchEngines(const Options &options)
+    {
+        double build = bestOf(options.runs, [&]() { sink = LL1Table::fromLanguageGrammar().getConflicts().size(); });
+        const LL1TableView &ll1 = LANGUAGE_LL1_TABLE;
+        size_t cells = static_cast<size_t>(ll1.symbolCount - ll1.terminalCount) * ll1.terminalCount;
+        row("LL(1) table from getGramatica()", build * 1e3, "ms");
+        row("LL(1) cells + FOLLOW bits", static_cast<double>(cells * (sizeof(int16_t) + sizeof(uint8_t))), "B");
+
+        build = bestOf(options.runs, [&]() { sink = LALRTable::fromLanguageGrammar().stateCount(); });
+        LALRTable lalr = LALRTable::fromLanguageGrammar();
+        row("LALR(1) table from getGramatica()", build * 1e3, "ms");
+        row("LALR(1) tables, " + std::to_string(lalr.stateCount()) + " states, compressed",
+            static_cast<double>(lalr.compressedBytes()), "B");
+        row("LALR(1) tables, dense", static_cast<double>(lalr.denseBytes()), "B");
+
+        const std::pair<const char *, std::string> inputs[] = {
+            {"generated program", ProgramGenerator(19).generate(options.bytes, 0)},
+            {"2000-term expressions", longExpressions(options.bytes / 4, 2000)}};
+        for (const auto &[name, text] : inputs)
+        {
+            TokenBuffer tokens = lexAll(text);
+            double count = static_cast<double>(tokens.size());
+            TokenCursor check(tokens);
+            TokenCursor checkLalr(tokens);
+            bool accepted = acceptedByParser(tokens) && PredictiveParser(check, ll1).parse() &&
+                            ShiftReduceParser(checkLalr, lalr).parse();
+            std::printf("  %s: %.1f MB, %zu tokens, accepted: %s\n", name, megabytes(text.size()), tokens.size(),
+                        accepted ? "yes" : "NO");
+
+            Ast ast;
+            row("Parser (with AST)", parseSeconds(tokens, ast, options.runs) * 1e9 / count, "ns/token");
+            double predictive = bestOf(options.runs, [&]() {
+                TokenCursor cursor(tokens);
+                sink = PredictiveParser(cursor, ll1).parse();
+            });
+            row("PredictiveParser (--ll1)", predictive * 1e9 / count, "ns/token");
+            double shiftReduce = bestOf(options.runs, [&]() {
+                TokenCursor cursor(tokens);
+                sink = ShiftReduceParser(cursor, lalr).parse();
+            });
+            row("ShiftReduceParser (--lalr)", shiftReduce * 1e9 / count, "ns/token");
+        }
+    }
+
+    // user-025: parse de um programa feito de muitos procedimentos, sequencial
+    // e com o passe de esqueleto e 1..N threads; a arvore tem de sair igual
+    void benchParallel(const Options &options)
+    {
+        std::string text = ProgramGenerator(23).generate(options.bytes, 32);
+        TokenBuffer tokens = lexAll(text);
+        unsigned cores = std::thread::hardware_concurrency();
+        std::printf("  %.1f MB, %zu tokens, accepted: %s; %u hardware threads\n", megabytes(text.size()),
+                    tokens.size(), acceptedByParser(tokens) ? "yes" : "NO", cores);
+
+        Ast sequentialAst;
+        double sequential = parseSeconds(tokens, sequentialAst, options.runs);
+        row("sequential", sequential * 1e3, "ms");
+        for (unsigned threads = 1; threads <= std::max(4u, cores); threads++)
+        {
+            Ast ast;
+            size_t diagnostics = 0;
+            double seconds = bestOf(options.runs, [&]() {
+                ast.clear();
+                TokenCursor cursor(tokens);
+                Parser parser(cursor, ast);
+                parser.setParallelParsing(0, threads);
+                parser.parseProgram();
+                diagnostics = parser.getDiagnostics().size();
+            });
+            bool same = diagnostics == 0 && ast.kinds == sequentialAst.kinds && ast.lhs == sequentialAst.lhs &&
+                        ast.rhs == sequentialAst.rhs && ast.extra == sequentialAst.extra;
+            std::string name = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+            row(name + (same ? "" : " (TREE DIFFERS)"), seconds * 1e3, "ms");
+            row(name + ", speedup", sequential / seconds, "x");
+        }
+    }
+
+    // Tempo de CPU (usuario + sistema) do processo ate aqui, de todas as threads
+    double cpuSeconds()
+    {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+               (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    // user-014: tokenizeAll e depois o parse contra o Scanner numa thread
+    // produtora (TokenPipeline) e o parse consumindo os lotes. Alem do tempo
+    // de parede, o tempo de CPU mostra quanto as duas threads gastam esperando
+    // uma pela outra.
+    void benchPipeline(const Options &options)
+    {
+        std::string text = ProgramGenerator(29).generate(options.bytes, 0);
+        std::printf("  %.1f MB, %u hardware threads\n", megabytes(text.size()), std::thread::hardware_concurrency());
+
+        Ast ast;
+        auto sequential = [&]() {
+            Scanner scanner(SourceBuffer::view(text.data(), text.size()));
+            scanner.setParallelLexing(SIZE_MAX);
+            TokenBuffer tokens = scanner.tokenizeAll();
+            ast.clear();
+            TokenCursor cursor(tokens);
+            Parser parser(cursor, ast);
+            parser.setParallelParsing(SIZE_MAX);
+            parser.parseProgram();
+            sink = parser.getDiagnostics().size();
+        };
+        auto pipelined = [&]() {
+            Scanner scanner(SourceBuffer::view(text.data(), text.size()));
+            TokenPipeline pipeline(scanner);
+            TokenCursor cursor(pipeline);
+            ast.clear();
+            Parser parser(cursor, ast);
+            parser.parseProgram();
+            pipeline.finish();
+            sink = parser.getDiagnostics().size();
+        };
+        for (const auto &[name, work] : {std::pair<const char *, std::function<void()>>{"tokenizeAll + parse", sequential},
+                                         std::pair<const char *, std::function<void()>>{"TokenPipeline + parse", pipelined}})
+        {
+            double cpu = 1e300;
+            double wall = bestOf(options.runs, [&, &work = work]() {
+                double start = cpuSeconds();
+                work();
+                cpu = std::min(cpu, cpuSeconds() - start);
+            });
+            row(std::string(name) + ", wall", wall * 1e3, "ms");
+            row(std::string(name) + ", CPU", cpu * 1e3, "ms");
+        }
+    }
+
+    struct Scenario
+    {
+        const char *name;
+        const char *request;
+        const char *summary;
+        void (*run)(const Options &);
+    };
+
+    const Scenario SCENARIOS[] = {
+        {"startup", "user-001", "source loading: first-token latency and peak RSS", benchStartup},
+        {"keywords", "user-005", "keyword classifier cost per token", benchKeywords},
+        {"simd", "user-007", "scanner throughput per SIMD level on comment- and identifier-heavy text", benchSimd},
+        {"oneline", "user-008", "lexing and locate() on a single multi-MB line", benchOneLine},
+        {"recovery", "user-012", "lexing cost of error recovery on clean and error-dense text", benchRecovery},
+        {"pipeline", "user-014", "sequential lex-then-parse against the lexer on a producer thread", benchPipeline},
+        {"parser", "user-016", "parse-only cost per token from pre-lexed tokens", benchParser},
+        {"ast", "user-017", "flat AST size per node and the cost of building and clearing it", benchAst},
+        {"errors", "user-018", "parse time with syntax error recovery, clean and with injected errors", benchErrors},
+        {"engines", "user-020 user-023", "parser engines on the same tokens and the cost of generating their tables",
+         benchEngines},
+        {"parallel", "user-025", "parallel parsing of top-level procedures by thread count", benchParallel},
+    };
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    std::vector<std::string> selected;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc)
+        {
+            options.runs = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--size" && i + 1 < argc)
+        {
+            options.bytes = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10)) * 1024 * 1024;
+        }
+        else if (arg == "--list")
+        {
+            for (const Scenario &scenario : SCENARIOS)
+            {
+                std::printf("%-10s %s  %s\n", scenario.name, scenario.request, scenario.summary);
+            }
+            return 0;
+        }
+        else
+        {
+            selected.push_back(arg);
+        }
+    }
+
+    for (const std::string &name : selected)
+    {
+        if (std::none_of(std::begin(SCENARIOS), std::end(SCENARIOS),
+                         [&](const Scenario &scenario) { return name == scenario.name; }))
+        {
+            std::cerr << "unknown scenario " << name << " (see --list)" << std::endl;
+            return 1;
+        }
+    }
+
+    std::printf("best of %d runs, %.0f MB corpora\n", options.runs, megabytes(options.bytes));
+    for (const Scenario &scenario : SCENARIOS)
+    {
+        if (!selected.empty() && std::find(selected.begin(), selected.end(), scenario.name) == selected.end())
+        {
+            continue;
+        }
+        std::printf("\n== %s (%s): %s\n", scenario.name, scenario.request, scenario.summary);
+        scenario.run(options);
+    }
+    return 0;
+}
@@ -0,0 +1,14 @@
+#!/bin/sh
+# Compila as fontes do compilador e o bench/Bench.cpp e roda os cenarios, a
+# partir da raiz do repositorio. Os argumentos vao para o benchmark:
+#
+#   bench/run.sh                          # todos os cenarios
+#   bench/run.sh --runs 10 startup        # so os indicados, melhor de 10
+#   bench/run.sh --list
+set -e
+cd "$(dirname "$0")/.."
+. scripts/objects.sh
+
+mkdir -p build/bench
+g++ $FLAGS bench/Bench.cpp $OBJECTS -pthread -o build/bench/bench
+build/bench/bench "$@"
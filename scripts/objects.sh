@@ -0,0 +1,21 @@
+# Incluido por tests/run.sh e bench/run.sh, a partir da raiz do repositorio:
+# compila as fontes do compilador (as mesmas do comando do README, sem o
+# main.cpp) em build/obj e deixa a lista dos objetos em OBJECTS.
+
+SOURCES="src/lexical/Scanner/Scanner.cpp src/lexical/Scanner/TableScanner.cpp src/lexical/Scanner/SimdScan.cpp
+src/lexical/Scanner/ParallelScanner.cpp src/lexical/Scanner/IncrementalScanner.cpp src/lexical/Scanner/StreamScanner.cpp
+src/lexical/Scanner/TokenPipeline.cpp src/lexical/Token/Token.cpp src/lexical/Diagnostic/Diagnostic.cpp
+src/lexical/Source/SourceBuffer.cpp src/lexical/Source/LineIndex.cpp src/lexical/Source/StreamSource.cpp
+src/lexical/Interner/Interner.cpp src/lexical/TokenBuffer/TokenBuffer.cpp src/parser/Parser.cpp
+src/parser/ParallelParser.cpp src/parser/ParserTrace.cpp src/parser/SyntaxDiagnostic.cpp src/parser/Ast/Ast.cpp
+src/parser/LL1/LL1Table.cpp src/parser/LL1/PredictiveParser.cpp src/parser/LR/LALRTable.cpp
+src/parser/LR/ShiftReduceParser.cpp src/parser/utils/operacoesGramatica.cpp src/parser/utils/Grammar.cpp"
+FLAGS="-std=c++17 -O2 -Wall -Wextra"
+
+mkdir -p build/obj
+OBJECTS=""
+for source in $SOURCES; do
+    object="build/obj/$(echo "$source" | sed 's|^src/||; s|/|_|g; s|\.cpp$|.o|')"
+    g++ $FLAGS -c "$source" -o "$object"
+    OBJECTS="$OBJECTS $object"
+done
@@ -0,0 +1,20 @@
+#include "Diagnostic.h"
+
+std::string formatDiagnostic(const Diagnostic &diagnostic, std::string_view lexeme, SourceLocation location)
+{
+    std::string where = "row " + std::to_string(location.row) + ", col " + std::to_string(location.col);
+    switch (diagnostic.code)
+    {
+    case DiagnosticCode::FORBIDDEN_SYMBOL:
+        return "You used a forbidden symbol at " + where + ": " + std::string(lexeme);
+    case DiagnosticCode::MISSING_EXPONENT_DIGITS:
+        return "Malformed floating point number at " + where + ": missing exponent digits";
+    case DiagnosticCode::MALFORMED_EXPONENT:
+        return "Malformed floating point number at " + where + ": malformed exponent";
+    case DiagnosticCode::INTEGER_OUT_OF_RANGE:
+        return "Integer literal out of range at " + where + ": " + std::string(lexeme);
+    case DiagnosticCode::REAL_OUT_OF_RANGE:
+        return "Real literal out of range at " + where + ": " + std::string(lexeme);
+    }
+    return "Lexical error at " + where;
+}
@@ -0,0 +1,30 @@
+#ifndef DIAGNOSTIC_H
+#define DIAGNOSTIC_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "../Source/LineIndex.h"
+
+enum class DiagnosticCode : uint8_t
+{
+    FORBIDDEN_SYMBOL,
+    MISSING_EXPONENT_DIGITS,
+    MALFORMED_EXPONENT,
+    INTEGER_OUT_OF_RANGE,
+    REAL_OUT_OF_RANGE,
+};
+
+// Erro lexico em forma compacta: o lexema rejeitado, sourceBuffer[offset,
+// offset + length), e o codigo. A mensagem so e montada em formatDiagnostic.
+struct Diagnostic
+{
+    uint32_t offset;
+    uint32_t length;
+    DiagnosticCode code;
+};
+
+std::string formatDiagnostic(const Diagnostic &diagnostic, std::string_view lexeme, SourceLocation location);
+
+#endif
@@ -0,0 +1,37 @@
+#include "Interner.h"
+
+Interner &Interner::global()
+{
+    static Interner instance;
+    return instance;
+}
+
+SymbolId Interner::intern(std::string_view name)
+{
+    auto found = ids.find(name);
+    if (found != ids.end())
+    {
+        return found->second;
+    }
+
+    SymbolId id = static_cast<SymbolId>(names.size());
+    names.emplace_back(name);
+    ids.emplace(names.back(), id);
+    return id;
+}
+
+SymbolId Interner::find(std::string_view name) const
+{
+    auto found = ids.find(name);
+    return found != ids.end() ? found->second : NO_SYMBOL;
+}
+
+std::string_view Interner::name(SymbolId id) const
+{
+    return names[id];
+}
+
+size_t Interner::size() const
+{
+    return names.size();
+}
@@ -0,0 +1,34 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Identificador denso de um nome internado. Os ids comecam em 0 e crescem de
+// um em um, entao podem indexar vetores diretamente.
+using SymbolId = uint32_t;
+
+constexpr SymbolId NO_SYMBOL = UINT32_MAX;
+
+// Tabela global de nomes: o Scanner interna cada identificador uma unica vez
+// e as fases seguintes comparam apenas SymbolIds.
+class Interner
+{
+private:
+    std::unordered_map<std::string_view, SymbolId> ids;
+    // deque nao realoca os elementos, entao as views em ids continuam validas
+    std::deque<std::string> names;
+
+public:
+    static Interner &global();
+
+    SymbolId intern(std::string_view name);
+    SymbolId find(std::string_view name) const;
+    std::string_view name(SymbolId id) const;
+    size_t size() const;
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include "Scanner.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+// Relexa apenas a regiao afetada por uma edicao. Lexar a partir do inicio de
+// um token e deterministico (so espacos e comentarios separam o ponto em que
+// o Scanner parou do proximo token), entao:
+//  - recomeca no ultimo token que termina antes da edicao: nenhum token le
+//    mais de um caractere alem do seu fim, logo ele e os anteriores nao mudam;
+//  - para assim que um token novo, ja depois do texto inserido, comeca onde
+//    comecava um token antigo (deslocado): dali em diante o texto e igual e
+//    os tokens tambem.
+TokenChange Scanner::relex(TokenBuffer &tokens, const SourceEdit &edit)
+{
+    if (stream)
+    {
+        throw std::logic_error("relex needs the whole source; a stream keeps only its current window");
+    }
+    if (edit.offset > sourceBuffer.size() || edit.removed > sourceBuffer.size() - edit.offset)
+    {
+        throw std::out_of_range("relex: edit [" + std::to_string(edit.offset) + ", +" + std::to_string(edit.removed) +
+                                ") outside a source of " + std::to_string(sourceBuffer.size()) + " bytes");
+    }
+    if (sourceBuffer.size() - edit.removed + edit.inserted.size() > MAX_SOURCE_SIZE)
+    {
+        throw std::length_error("relex: edited source passes Scanner::MAX_SOURCE_SIZE (32-bit offsets)");
+    }
+
+    const bool withSymbols = !tokens.symbols.empty() || tokens.size() == 0;
+    const long long delta = static_cast<long long>(edit.inserted.size()) - static_cast<long long>(edit.removed);
+    const size_t oldCount = tokens.size();
+
+    // Ultimo token com fim < edit.offset
+    size_t restart = 0;
+    size_t begin = 0;
+    {
+        auto first = std::partition_point(tokens.offsets.begin(), tokens.offsets.end(), [&](uint32_t offset) {
+            return offset < edit.offset;
+        });
+        size_t index = first - tokens.offsets.begin();
+        while (index > 0)
+        {
+            index--;
+            if (tokens.offsets[index] + tokens.lengths[index] < edit.offset)
+            {
+                begin = index;
+                restart = tokens.offsets[index];
+                break;
+            }
+        }
+    }
+
+    sourceBuffer.replace(edit.offset, edit.removed, edit.inserted);
+    lineIndex.reset();
+    limit = sourceBuffer.size();
+    tokens.source = sourceBuffer.data();
+    tokens.endOffset = static_cast<uint32_t>(limit);
+
+    // Primeiro token antigo que comeca depois do texto removido: candidatos
+    // a ressincronizar
+    const size_t editEnd = edit.offset + edit.inserted.size();
+    size_t candidate = std::partition_point(tokens.offsets.begin() + begin, tokens.offsets.end(), [&](uint32_t offset) {
+        return offset < edit.offset + edit.removed;
+    }) - tokens.offsets.begin();
+
+    TokenBuffer fresh;
+    size_t oldEnd = oldCount;
+    const size_t firstFresh = diagnostics.size();
+    pos = restart;
+    while (true)
+    {
+        Token token = nextToken();
+        if (token.getType() == TokenType::NONE)
+        {
+            break;
+        }
+
+        if (token.getOffset() >= editEnd)
+        {
+            // Avanca os candidatos ate a posicao equivalente no texto antigo
+            long long oldOffset = static_cast<long long>(token.getOffset()) - delta;
+            while (candidate < oldCount && tokens.offsets[candidate] < oldOffset)
+            {
+                candidate++;
+            }
+            if (candidate < oldCount && tokens.offsets[candidate] == oldOffset)
+            {
+                oldEnd = candidate;
+                break;
+            }
+        }
+        fresh.push(token, withSymbols);
+    }
+
+    // Descarta do inicio os tokens relexados que nao mudaram (inteiros antes
+    // da edicao, onde o texto e o mesmo)
+    size_t same = 0;
+    while (same < fresh.size() && begin + same < oldEnd &&
+           fresh.offsets[same] + fresh.lengths[same] <= edit.offset &&
+           fresh.kinds[same] == tokens.kinds[begin + same] &&
+           fresh.offsets[same] == tokens.offsets[begin + same] &&
+           fresh.lengths[same] == tokens.lengths[begin + same])
+    {
+        same++;
+    }
+
+    // Diagnosticos acompanham os tokens ERROR: os da faixa relexada sao
+    // trocados pelos novos e os seguintes sao deslocados
+    {
+        const size_t oldStop = oldEnd < oldCount ? tokens.offsets[oldEnd] : SIZE_MAX;
+        const size_t newStop = oldEnd < oldCount ? static_cast<size_t>(oldStop + delta) : SIZE_MAX;
+        std::vector<Diagnostic> merged;
+        for (size_t i = 0; i < firstFresh; i++)
+        {
+            if (diagnostics[i].offset < restart)
+            {
+                merged.push_back(diagnostics[i]);
+            }
+        }
+        for (size_t i = firstFresh; i < diagnostics.size(); i++)
+        {
+            if (diagnostics[i].offset < newStop)
+            {
+                merged.push_back(diagnostics[i]);
+            }
+        }
+        for (size_t i = 0; i < firstFresh; i++)
+        {
+            if (diagnostics[i].offset >= oldStop)
+            {
+                Diagnostic shifted = diagnostics[i];
+                shifted.offset = static_cast<uint32_t>(shifted.offset + delta);
+                merged.push_back(shifted);
+            }
+        }
+        diagnostics = std::move(merged);
+    }
+
+    // Desloca os tokens depois da edicao e troca a faixa alterada
+    for (size_t i = oldEnd; i < oldCount; i++)
+    {
+        tokens.offsets[i] = static_cast<uint32_t>(tokens.offsets[i] + delta);
+    }
+
+    auto splice = [&](auto &column, const auto &replacement) {
+        column.erase(column.begin() + begin + same, column.begin() + oldEnd);
+        column.insert(column.begin() + begin + same, replacement.begin() + same, replacement.end());
+    };
+    splice(tokens.kinds, fresh.kinds);
+    splice(tokens.keywords, fresh.keywords);
+    splice(tokens.offsets, fresh.offsets);
+    splice(tokens.lengths, fresh.lengths);
+    if (withSymbols)
+    {
+        // Os valores novos vao para o fim de literals; os da faixa trocada
+        // ficam orfaos, o que so custa memoria ate o proximo tokenizeAll
+        const SymbolId literalBase = static_cast<SymbolId>(tokens.literals.size());
+        for (size_t i = 0; i < fresh.size(); i++)
+        {
+            if (TokenBuffer::isNumeric(fresh.kinds[i]))
+            {
+                fresh.symbols[i] += literalBase;
+            }
+        }
+        tokens.literals.insert(tokens.literals.end(), fresh.literals.begin(), fresh.literals.end());
+        splice(tokens.symbols, fresh.symbols);
+    }
+
+    pos = limit;
+    currentToken = makeToken(TokenType::NONE, limit, limit);
+    return TokenChange{begin + same, oldEnd, begin + fresh.size()};
+}
@@ -0,0 +1,141 @@
+#include "Scanner.h"
+#include "SimdScan.h"
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <utility>
+
+// Lexa trechos do fonte em paralelo. Os cortes caem logo depois de um '\n':
+// nenhum token contem '\n' nem precisa ler alem dele, e um comentario termina
+// no '\n', entao cada trecho comeca no estado inicial exatamente como o
+// Scanner sequencial chegaria ali. Os offsets sao globais, logo linha/coluna
+// dos erros nao precisam de ajuste.
+
+namespace
+{
+    struct Chunk
+    {
+        size_t begin;
+        size_t end;
+        TokenBuffer tokens;
+        Interner names;
+        std::vector<Diagnostic> diagnostics;
+        std::exception_ptr error;
+    };
+}
+
+TokenBuffer Scanner::tokenizeParallel(bool withSymbols, unsigned threads)
+{
+    const char *data = sourceBuffer.data();
+
+    // Mais trechos que threads para equilibrar a carga
+    size_t chunkCount = threads * 4;
+    size_t chunkSize = (limit - pos) / chunkCount + 1;
+    std::vector<Chunk> chunks;
+    size_t begin = pos;
+    while (begin < limit)
+    {
+        size_t cut = begin + chunkSize;
+        cut = cut >= limit ? limit : findNewline(data, cut, limit);
+        size_t end = cut < limit ? cut + 1 : limit;
+        chunks.push_back(Chunk{begin, end, TokenBuffer(), Interner(), {}, nullptr});
+        begin = end;
+    }
+
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]() {
+        size_t index;
+        while ((index = nextChunk++) < chunks.size())
+        {
+            Chunk &chunk = chunks[index];
+            try
+            {
+                Scanner part(SourceBuffer::view(data, sourceBuffer.size()));
+                part.engine = engine;
+                part.pos = chunk.begin;
+                part.limit = chunk.end;
+                part.interner = &chunk.names;
+                part.parallelThreshold = SIZE_MAX;
+                part.errorRecovery = errorRecovery;
+                chunk.tokens = part.tokenizeAll(true);
+                chunk.diagnostics = std::move(part.diagnostics);
+            }
+            catch (...)
+            {
+                chunk.error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads && i < chunks.size(); i++)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : pool)
+    {
+        thread.join();
+    }
+
+    // O primeiro erro na ordem do fonte e o que o Scanner sequencial lancaria
+    for (Chunk &chunk : chunks)
+    {
+        if (chunk.error)
+        {
+            std::rethrow_exception(chunk.error);
+        }
+    }
+
+    size_t total = 0;
+    for (const Chunk &chunk : chunks)
+    {
+        total += chunk.tokens.size();
+    }
+
+    TokenBuffer tokens;
+    tokens.source = data;
+    tokens.endOffset = static_cast<uint32_t>(limit);
+    tokens.reserve(total, withSymbols);
+
+    std::vector<SymbolId> remap;
+    for (Chunk &chunk : chunks)
+    {
+        const TokenBuffer &part = chunk.tokens;
+        tokens.kinds.insert(tokens.kinds.end(), part.kinds.begin(), part.kinds.end());
+        tokens.keywords.insert(tokens.keywords.end(), part.keywords.begin(), part.keywords.end());
+        tokens.offsets.insert(tokens.offsets.end(), part.offsets.begin(), part.offsets.end());
+        tokens.lengths.insert(tokens.lengths.end(), part.lengths.begin(), part.lengths.end());
+
+        // Internar os nomes de cada trecho em ordem preserva os ids que o
+        // Scanner sequencial teria atribuido
+        remap.resize(chunk.names.size());
+        for (SymbolId id = 0; id < remap.size(); id++)
+        {
+            remap[id] = interner->intern(chunk.names.name(id));
+        }
+        if (withSymbols)
+        {
+            // Indices de literais sao deslocados pelos literais dos trechos anteriores
+            const SymbolId literalBase = static_cast<SymbolId>(tokens.literals.size());
+            for (size_t i = 0; i < part.size(); i++)
+            {
+                SymbolId symbol = part.symbols[i];
+                if (TokenBuffer::isNumeric(part.kinds[i]))
+                {
+                    tokens.symbols.push_back(literalBase + symbol);
+                }
+                else
+                {
+                    tokens.symbols.push_back(symbol == NO_SYMBOL ? NO_SYMBOL : remap[symbol]);
+                }
+            }
+            tokens.literals.insert(tokens.literals.end(), part.literals.begin(), part.literals.end());
+        }
+        diagnostics.insert(diagnostics.end(), chunk.diagnostics.begin(), chunk.diagnostics.end());
+    }
+
+    pos = limit;
+    currentToken = makeToken(TokenType::NONE, limit, limit);
+    return tokens;
+}
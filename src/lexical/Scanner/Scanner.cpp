@@ -1,53 +1,101 @@
 #include "Scanner.h"
-#include <fstream>
+#include "SimdScan.h"
+#include <algorithm>
+#include <utility>
 #include <stdexcept>
+#include <charconv>
 #include <cctype>
-#include <vector>
-#include <unordered_map>
+#include <thread>
 
-Scanner::Scanner(const std::string &source) : pos(0), row(1), col(0)
+// Abaixo disso o custo de criar as threads nao compensa
+constexpr size_t DEFAULT_PARALLEL_THRESHOLD = 8 * 1024 * 1024;
+
+Scanner::Scanner(const std::string &source, bool useMmap) : Scanner(SourceBuffer::fromFile(source, useMmap))
+{
+}
+
+Scanner::Scanner(SourceBuffer source)
+    : engine(ScannerEngine::SWITCH), sourceBuffer(std::move(source)), pos(0), limit(sourceBuffer.size()),
+      interner(&Interner::global()), parallelThreshold(DEFAULT_PARALLEL_THRESHOLD), parallelThreads(0),
+      errorRecovery(false), base(0)
 {
-    std::ifstream file(source);
-    if (file.is_open())
+    if (sourceBuffer.size() > MAX_SOURCE_SIZE)
     {
-        std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-        sourceBuffer = std::vector<char>(buffer.begin(), buffer.end());
-        file.close();
+        throw std::length_error("source of " + std::to_string(sourceBuffer.size()) +
+                                " bytes passes Scanner::MAX_SOURCE_SIZE (32-bit offsets)");
     }
-    else
+}
+
+Scanner::Scanner(std::unique_ptr<StreamSource> source) : Scanner(SourceBuffer())
+{
+    stream = std::move(source);
+}
+
+void Scanner::setEngine(ScannerEngine engine)
+{
+    this->engine = engine;
+}
+
+void Scanner::setParallelLexing(size_t threshold, unsigned threads)
+{
+    parallelThreshold = threshold;
+    parallelThreads = threads;
+}
+
+void Scanner::setErrorRecovery(bool enabled)
+{
+    errorRecovery = enabled;
+}
+
+const std::vector<Diagnostic> &Scanner::getDiagnostics() const
+{
+    return diagnostics;
+}
+
+std::string Scanner::renderDiagnostic(const Diagnostic &diagnostic)
+{
+    if (diagnostic.offset < base)
     {
-        throw std::runtime_error("Unable to open file");
+        // O lexema ja saiu da janela; os diagnosticos estao em ordem de offset
+        auto found = std::lower_bound(diagnostics.begin(), diagnostics.end(), diagnostic.offset,
+                                      [](const Diagnostic &stored, uint32_t offset) { return stored.offset < offset; });
+        if (found != diagnostics.end() && found->offset == diagnostic.offset)
+        {
+            return streamMessages[found - diagnostics.begin()];
+        }
+        return formatDiagnostic(diagnostic, {}, {0, 0});
     }
+    size_t start = diagnostic.offset - base;
+    return formatDiagnostic(diagnostic, lexeme(start, start + diagnostic.length),
+                            locate(diagnostic.offset));
 }
 
 Token Scanner::nextToken()
 {
-    reservedWords = {
-        {"program", "program"},
-        {"var", "var"},
-        {"integer", "integer"},
-        {"real", "real"},
-        {"boolean", "boolean"},
-        {"procedure", "procedure"},
-        {"begin", "begin"},
-        {"end", "end"},
-        {"if", "if"},
-        {"then", "then"},
-        {"else", "else"},
-        {"while", "while"},
-        {"do", "do"},
-        {"not", "not"}};
+    if (stream)
+    {
+        return nextStreamToken(true);
+    }
+    if (engine == ScannerEngine::TABLE)
+    {
+        return nextTokenTable();
+    }
+    return nextTokenSwitch();
+}
 
+Token Scanner::nextTokenSwitch()
+{
     state = 0;
     char currentChar;
-    std::string content = "";
-    auto existReserved = reservedWords.find(content);
+    // Lexema atual: sourceBuffer[start, end), sem copiar caracteres
+    size_t start = pos;
+    size_t end = pos;
 
     while (true)
     {
         if (isEOF())
         {
-            currentToken = Token(TokenType::NONE, "");
+            currentToken = makeToken(TokenType::NONE, pos, pos);
             return currentToken;
         }
         currentChar = nextChar();
@@ -57,26 +105,32 @@ Token Scanner::nextToken()
         case 0:
             if (isSpace(currentChar))
             {
+                // Pula o restante da sequencia de espacos de uma vez
+                pos = skipSpaces(sourceBuffer.data(), pos, limit);
                 state = 0;
             }
             else if (isLetter(currentChar))
             {
-                content += currentChar;
+                start = pos - 1;
+                end = pos;
                 state = 1;
             }
             else if (isDigit(currentChar))
             {
-                content += currentChar;
+                start = pos - 1;
+                end = pos;
                 state = 3;
             }
             else if (isRelationalOperator(currentChar))
             {
-                content += currentChar;
+                start = pos - 1;
+                end = pos;
                 state = 7; // Transição para operadores relacionais
             }
             else if (isDelimiter(currentChar))
             {
-                content += currentChar;
+                start = pos - 1;
+                end = pos;
                 if (currentChar == ':')
                 {
                     state = 13;
@@ -92,17 +146,18 @@ Token Scanner::nextToken()
             }
             else if (isEquationOperator(currentChar))
             {
-                content += currentChar;
+                start = pos - 1;
+                end = pos;
                 state = 11; // Transição para operadores matemáticos
             }
             else if (isHashtag(currentChar))
             {
-                content += currentChar;
                 state = 12; // Transição para comentários
             }
             else
             {
-                throw std::runtime_error("You used a forbidden symbol at row " + std::to_string(row) + ", col " + std::to_string(col) + ": " + currentChar);
+                currentToken = lexicalError(DiagnosticCode::FORBIDDEN_SYMBOL, pos - 1, pos);
+                return currentToken;
             }
             break;
 
@@ -110,7 +165,8 @@ Token Scanner::nextToken()
             if (isLetter(currentChar) || isDigit(currentChar) || currentChar == '_')
             {
                 // std::cout << "Lendo caractere: " << currentChar << " (conteúdo atual: " << content << ")" << std::endl;
-                content += currentChar;
+                pos = skipIdentifier(sourceBuffer.data(), pos, limit);
+                end = pos;
                 state = 1;
             }
             else
@@ -126,23 +182,7 @@ Token Scanner::nextToken()
             break;
 
         case 2:
-            existReserved = reservedWords.find(content);
-            if (existReserved != reservedWords.end())
-            {
-                currentToken = Token(TokenType::KEYWORD, existReserved->second);
-            }
-            else if (content == "AND" || content == "and")
-            {
-                currentToken = Token(TokenType::MULT_OPERATOR, content);
-            }
-            else if (content == "OR" || content == "or")
-            {
-                currentToken = Token(TokenType::ADD_OPERATOR, content);
-            }
-            else
-            {
-                currentToken = Token(TokenType::IDENTIFIER, content);
-            }
+            currentToken = makeWordToken(start, end);
             
             //Aqui, o currentChar precisa ser igual a currentChar -1 posição. Como posso fazer isso com o que tem implementado aqui nesse aqruivo chat?
             back();
@@ -151,17 +191,17 @@ Token Scanner::nextToken()
         case 3: // Parte inteira do número
             if (isDigit(currentChar))
             {
-                content += currentChar;
+                end = pos;
             }
             else if (currentChar == '.')
             {
-                content += currentChar;
+                end = pos;
                 state = 4; // Transição para processar a parte fracionária
             }
             else
             {
                 back();
-                currentToken = Token(TokenType::NUMBER, content);
+                currentToken = makeNumberToken(TokenType::NUMBER, start, end);
                 return currentToken; // Número inteiro
             }
             break;
@@ -169,67 +209,71 @@ Token Scanner::nextToken()
         case 4: // Parte fracionária ou delimitador
             if (isDigit(currentChar) || currentChar == 'E' || currentChar == 'e')
             {
-                content += currentChar; // Continua processando a parte fracionária
+                end = pos; // Continua processando a parte fracionária
                 state = 5;              // Transição para processar a parte exponencial
             }
             else
             {
-                throw std::runtime_error("Malformed floating point number at row " + std::to_string(row) + ", col " + std::to_string(col) + ": missing exponent digits");
+                back();
+                currentToken = lexicalError(DiagnosticCode::MISSING_EXPONENT_DIGITS, start, end);
+                return currentToken;
             }
             break;
 
         case 5: // Parte exponencial
             if (isDigit(currentChar) || currentChar == '+' || currentChar == '-')
             {
-                content += currentChar; // Expoente sem sinal, processa diretamente
+                end = pos; // Expoente sem sinal, processa diretamente
                 state = 6;              // Vai para o estado que processa os dígitos do expoente
             }
             else
             {
-                if (isDigit(content.back()))
+                if (isDigit(sourceBuffer[end - 1]))
                 {
                     back();
-                    currentToken = Token(TokenType::FLOAT_NUMBER, content);
+                    currentToken = makeNumberToken(TokenType::FLOAT_NUMBER, start, end);
                     return currentToken; // Retorna número flutuante com expoente
                 }
-                throw std::runtime_error("Malformed floating point number at row " + std::to_string(row) + ", col " + std::to_string(col) + ": missing exponent digits");
+                back();
+                currentToken = lexicalError(DiagnosticCode::MISSING_EXPONENT_DIGITS, start, end);
+                return currentToken;
             }
             break;
 
         case 6: // Processa dígitos do expoente
             if (isDigit(currentChar))
             {
-                content += currentChar; // Continua processando os dígitos do expoente
+                end = pos; // Continua processando os dígitos do expoente
             }
             else
             {
                 back();
-                currentToken = Token(TokenType::FLOAT_NUMBER, content);
+                currentToken = makeNumberToken(TokenType::FLOAT_NUMBER, start, end);
                 return currentToken; // Retorna número flutuante com expoente
             }
             break;
         case 7:
             if (currentChar == '=')
             {
-                content += currentChar;
+                end = pos;
                 state = 9; // Transição para verificar operador relacional com '='
             }
-            else if (content.back() == '<' && currentChar == '>')
+            else if (sourceBuffer[end - 1] == '<' && currentChar == '>')
             {
-                content += currentChar;
-                currentToken = Token(TokenType::REL_OPERATOR, content);
+                end = pos;
+                currentToken = makeToken(TokenType::REL_OPERATOR, start, end);
                 return currentToken;
             }
             else if (isSpace(currentChar) || isDigit(currentChar))
             {
                 back();
-                currentToken = Token(content[0] == '=' ? TokenType::EQUAL_OPERATOR : TokenType::REL_OPERATOR, content);
+                currentToken = makeToken(sourceBuffer[start] == '=' ? TokenType::EQUAL_OPERATOR : TokenType::REL_OPERATOR, start, end);
                 return currentToken;
             }
             else
             {
                 back();
-                currentToken = Token(TokenType::LOGICAL_OPERATOR, content);
+                currentToken = makeToken(TokenType::LOGICAL_OPERATOR, start, end);
                 return currentToken;
             }
             break;
@@ -237,12 +281,12 @@ Token Scanner::nextToken()
         case 8:
             if (isRelationalOperator(currentChar) && currentChar == '=')
             {
-                content += currentChar;
+                end = pos;
                 state = 9;
             }
             else
             {
-                currentToken = Token(TokenType::LOGICAL_OPERATOR, content);
+                currentToken = makeToken(TokenType::LOGICAL_OPERATOR, start, end);
                 return currentToken;
             }
             break;
@@ -251,70 +295,74 @@ Token Scanner::nextToken()
             {
                 back();
             }
-            currentToken = Token(TokenType::REL_OPERATOR, content);
+            currentToken = makeToken(TokenType::REL_OPERATOR, start, end);
             return currentToken;
 
             break;
         case 10:
             if (currentChar == ';')
             {
-                currentToken = Token(TokenType::DELIMITER, content);
+                currentToken = makePunctuatorToken(TokenType::DELIMITER, start, end);
                 return currentToken;
             }
             if (isRelationalOperator(currentChar))
             {
                 back();
             }
-            currentToken = Token(TokenType::DELIMITER, content);
+            currentToken = makePunctuatorToken(TokenType::DELIMITER, start, end);
             return currentToken;
             break;
 
         case 11:
-            if (content.back() == '+' || content.back() == '-')
+            if (sourceBuffer[end - 1] == '+' || sourceBuffer[end - 1] == '-')
             {
                 back();
-                currentToken = Token(TokenType::ADD_OPERATOR, content);
+                currentToken = makeToken(TokenType::ADD_OPERATOR, start, end);
                 return currentToken;
             }
             else
             {
                 back();
-                currentToken = Token(TokenType::MULT_OPERATOR, content);
+                currentToken = makeToken(TokenType::MULT_OPERATOR, start, end);
                 return currentToken;
             }
             break;
 
         case 12:
-            while (!isEOF() && currentChar != '\n')
+            if (currentChar != '\n')
             {
-                currentChar = nextChar();
+                // Salta direto para o fim da linha; o '\n' e consumido por nextChar
+                pos = findNewline(sourceBuffer.data(), pos, limit);
+                if (!isEOF())
+                {
+                    nextChar();
+                }
             }
             state = 0;
-            content = "";
             break;
         case 13:
             if (currentChar == '=')
             {
-                content += currentChar;
-                currentToken = Token(TokenType::ASSIGNMENT, content);
+                end = pos;
+                currentToken = makePunctuatorToken(TokenType::ASSIGNMENT, start, end);
                 return currentToken;
             }
             else
             {
                 back();
-                currentToken = Token(TokenType::DELIMITER, content);
+                currentToken = makePunctuatorToken(TokenType::DELIMITER, start, end);
                 return currentToken;
             }
         case 14:
             if (isDigit(currentChar) || currentChar == 'E' || currentChar == 'e')
             {
-                content += currentChar;
+                end = pos;
                 state = 4;
             }
             else
             {
                 back();
-                currentToken = Token(TokenType::DELIMITER, content);
+                currentToken = makePunctuatorToken(TokenType::DELIMITER, start, end);
                 return currentToken;
             }
         default:
@@ -323,6 +371,134 @@ Token Scanner::nextToken()
     }
 }
 
+Token Scanner::makeToken(TokenType type, size_t start, size_t end) const
+{
+    return Token(type, lexeme(start, end), static_cast<uint32_t>(base + start));
+}
+
+// Palavra completa: palavra reservada, operador and/or ou identificador
+Token Scanner::makeWordToken(size_t start, size_t end)
+{
+    std::string_view word = lexeme(start, end);
+    Keyword keyword = classifyKeyword(word);
+    if (keyword != Keyword::NONE)
+    {
+        TokenType type = keyword == Keyword::AND  ? TokenType::MULT_OPERATOR
+                         : keyword == Keyword::OR ? TokenType::ADD_OPERATOR
+                                                  : TokenType::KEYWORD;
+        Token token = makeToken(type, start, end);
+        token.setKeyword(keyword);
+        return token;
+    }
+    return Token(TokenType::IDENTIFIER, word, static_cast<uint32_t>(base + start), interner->intern(word));
+}
+
+// Delimitador ou ":=", ja com a Keyword da pontuacao
+Token Scanner::makePunctuatorToken(TokenType type, size_t start, size_t end) const
+{
+    Token token = makeToken(type, start, end);
+    token.setKeyword(classifyPunctuator(lexeme(start, end)));
+    return token;
+}
+
+// Literal numerico com o valor ja decodificado, para que as fases seguintes nao
+// precisem converter o texto de novo
+Token Scanner::makeNumberToken(TokenType type, size_t start, size_t end)
+{
+    const char *first = sourceBuffer.data() + start;
+    const char *last = sourceBuffer.data() + end;
+    NumericValue value{0};
+    std::from_chars_result result;
+
+    if (type == TokenType::NUMBER)
+    {
+        result = std::from_chars(first, last, value.integer);
+        if (result.ec == std::errc::result_out_of_range)
+        {
+            return lexicalError(DiagnosticCode::INTEGER_OUT_OF_RANGE, start, end);
+        }
+    }
+    else
+    {
+        result = std::from_chars(first, last, value.real);
+        if (result.ec == std::errc::result_out_of_range)
+        {
+            return lexicalError(DiagnosticCode::REAL_OUT_OF_RANGE, start, end);
+        }
+        // O automato aceita sinais e 'E' soltos ("1.e+", "1.5-3"); o que
+        // sobra depois da parte valida e um expoente mal formado
+        if (result.ptr != last)
+        {
+            return lexicalError(DiagnosticCode::MALFORMED_EXPONENT, start, end);
+        }
+    }
+
+    Token token = makeToken(type, start, end);
+    token.setValue(value);
+    return token;
+}
+
+// Caminho de erro, fora do laco principal: so aqui se monta mensagem ou se
+// lanca excecao
+__attribute__((cold)) Token Scanner::lexicalError(DiagnosticCode code, size_t start, size_t end)
+{
+    Diagnostic diagnostic{static_cast<uint32_t>(base + start), static_cast<uint32_t>(end - start), code};
+    if (!errorRecovery)
+    {
+        raise(diagnostic);
+    }
+    diagnostics.push_back(diagnostic);
+    if (stream)
+    {
+        streamMessages.push_back(renderDiagnostic(diagnostic));
+    }
+    return makeToken(TokenType::ERROR, start, end);
+}
+
+__attribute__((cold, noinline)) void Scanner::raise(const Diagnostic &diagnostic)
+{
+    throw std::runtime_error(renderDiagnostic(diagnostic));
+}
+
+// Le o restante do arquivo de uma vez. O buffer resultante pode ser percorrido
+// por varias fases (dump, parser) sem relexar.
+TokenBuffer Scanner::tokenizeAll(bool withSymbols)
+{
+    if (stream)
+    {
+        throw std::logic_error("tokenizeAll needs the whole source; read a stream with nextToken or a TokenCursor");
+    }
+    if (limit - pos >= parallelThreshold)
+    {
+        unsigned threads = parallelThreads ? parallelThreads : std::thread::hardware_concurrency();
+        if (threads > 1)
+        {
+            return tokenizeParallel(withSymbols, threads);
+        }
+    }
+
+    TokenBuffer tokens;
+    tokens.source = sourceBuffer.data();
+    tokens.endOffset = static_cast<uint32_t>(limit);
+    tokens.reserve((limit - pos) / 4, withSymbols);
+
+    while (true)
+    {
+        Token token = nextToken();
+        if (token.getType() == TokenType::NONE)
+        {
+            break;
+        }
+        tokens.push(token, withSymbols);
+    }
+    return tokens;
+}
+
+std::string_view Scanner::lexeme(size_t start, size_t end) const
+{
+    return std::string_view(sourceBuffer.data() + start, end - start);
+}
+
 Token Scanner::getCurrentToken()
 {
     return currentToken; // Apenas retorna o token atual sem avançar
@@ -370,41 +546,25 @@ bool Scanner::isHashtag(char c)
 
 char Scanner::nextChar()
 {
-    char c = sourceBuffer[pos++];
-    if (c == '\n')
-    {
-        row++;
-        col = 0;
-    }
-    else
-    {
-        col++;
-    }
-    return c;
+    return sourceBuffer[pos++];
 }
 
+// Linha e coluna nao sao mais mantidas a cada byte: voltar e O(1)
 void Scanner::back()
 {
     pos--;
+}
 
-    if (sourceBuffer[pos] == '\n')
-    {
-        row--;
-        col = 0;
-        size_t tempPos = pos - 1;
-        while (tempPos > 0 && sourceBuffer[tempPos] != '\n')
-        {
-            col++;
-            tempPos--;
-        }
-    }
-    else
+SourceLocation Scanner::locate(size_t offset)
+{
+    if (offset < base || offset - base > sourceBuffer.size())
     {
-        col--;
+        return {0, 0};
     }
+    return lineIndex.locate(sourceBuffer.data(), sourceBuffer.size(), offset);
 }
 
 bool Scanner::isEOF()
 {
-    return pos >= sourceBuffer.size();
+    return pos >= limit;
 }
@@ -2,26 +2,98 @@
 #define SCANNER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
+#include <memory>
 
 #include "../Token/Token.h"
+#include "../Token/Keyword.h"
+#include "../Source/SourceBuffer.h"
+#include "../Source/LineIndex.h"
+#include "../Source/StreamSource.h"
+#include "../TokenBuffer/TokenBuffer.h"
+#include "../Diagnostic/Diagnostic.h"
 
-class Scanner
+// Motor usado por nextToken(): o automato original com switch ou o DFA
+// dirigido por tabelas (TableScanner.cpp). Ambos produzem os mesmos tokens.
+enum class ScannerEngine
+{
+    SWITCH,
+    TABLE,
+};
+
+// Edicao do fonte: remove `removed` bytes a partir de offset e insere `inserted`
+struct SourceEdit
+{
+    size_t offset;
+    size_t removed;
+    std::string_view inserted;
+};
+
+// Resultado de Scanner::relex: os tokens [begin, oldEnd) do buffer antigo
+// foram trocados pelos tokens [begin, newEnd) do buffer novo
+struct TokenChange
+{
+    size_t begin;
+    size_t oldEnd;
+    size_t newEnd;
+};
+
+class Scanner : public TokenSource
 {
 private:
+    ScannerEngine engine;
     int state;
-    std::vector<char> sourceBuffer;
-    int pos;
-    int row;
-    int col;
-    std::unordered_map<std::string, std::string> reservedWords;
+    SourceBuffer sourceBuffer;
+    size_t pos;
+    // Fim da regiao lexada; menor que o buffer nos trechos do modo paralelo
+    size_t limit;
+    LineIndex lineIndex;
     Token currentToken;
+    Interner *interner;
+    size_t parallelThreshold;
+    unsigned parallelThreads;
+    bool errorRecovery;
+    std::vector<Diagnostic> diagnostics;
+    // Streaming com recovery: a mensagem de cada diagnostico, montada enquanto
+    // o lexema ainda estava na janela
+    std::vector<std::string> streamMessages;
+    // Fonte em streaming: sourceBuffer e so uma visao da janela atual e pos,
+    // limit etc. sao relativos a ela; base e o offset da janela no fluxo
+    std::unique_ptr<StreamSource> stream;
+    size_t base;
 
 public:
-    Scanner(const std::string &source);
+    // Offsets de Token, TokenBuffer e Diagnostic sao uint32_t: um fonte maior
+    // (arquivo, resultado de relex ou fluxo) lanca std::length_error
+    static constexpr size_t MAX_SOURCE_SIZE = UINT32_MAX;
+
+    Scanner(const std::string &source, bool useMmap = true);
+    explicit Scanner(SourceBuffer source);
+    // Le o fonte aos poucos. Sem tokenizeAll/relex: os tokens sao consumidos
+    // com nextToken (texto valido ate a proxima chamada) ou por um TokenCursor
+    explicit Scanner(std::unique_ptr<StreamSource> source);
     Token nextToken();
+    TokenBuffer tokenizeAll(bool withSymbols = true);
+    // Aplica a edicao ao fonte e atualiza tokens (de tokenizeAll deste
+    // Scanner). Lanca std::out_of_range se a edicao sai do fonte e
+    // std::logic_error num Scanner em streaming.
+    TokenChange relex(TokenBuffer &tokens, const SourceEdit &edit);
     Token getCurrentToken();
+    bool refill(TokenBuffer &batch) override;
+    bool isStreaming() const { return stream != nullptr; }
+    void setEngine(ScannerEngine engine);
+    // Linha e coluna (a partir de 1) do byte em offset, como nos erros. No
+    // streaming so a janela atual e localizavel; fora dela devolve {0, 0}.
+    SourceLocation locate(size_t offset) override;
+    // tokenizeAll divide entradas a partir de threshold bytes entre threads
+    // (0 = uma por nucleo). SIZE_MAX desliga o modo paralelo.
+    void setParallelLexing(size_t threshold, unsigned threads = 0);
+    // Com recovery ligado, erros lexicos viram tokens ERROR e diagnosticos em
+    // vez de excecoes, e o Scanner continua depois do lexema rejeitado
+    void setErrorRecovery(bool enabled);
+    const std::vector<Diagnostic> &getDiagnostics() const;
+    std::string renderDiagnostic(const Diagnostic &diagnostic);
 
         private : bool isDigit(char c);
     bool isLetter(char c);
@@ -34,6 +106,18 @@ public:
     char nextChar();
     void back();
     bool isEOF();
+    std::string_view lexeme(size_t start, size_t end) const;
+    Token makeToken(TokenType type, size_t start, size_t end) const;
+    Token makeWordToken(size_t start, size_t end);
+    Token makeNumberToken(TokenType type, size_t start, size_t end);
+    Token makePunctuatorToken(TokenType type, size_t start, size_t end) const;
+    Token lexicalError(DiagnosticCode code, size_t start, size_t end);
+    [[noreturn]] void raise(const Diagnostic &diagnostic);
+    Token nextTokenSwitch();
+    Token nextTokenTable();
+    Token nextStreamToken(bool canRefill);
+    void refillStream(size_t keepFrom);
+    TokenBuffer tokenizeParallel(bool withSymbols, unsigned threads);
 };
 
 #endif
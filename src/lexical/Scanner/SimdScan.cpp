@@ -0,0 +1,241 @@
+#include "SimdScan.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_SCAN_X86 1
+#endif
+
+namespace
+{
+    inline bool isSpaceByte(unsigned char c)
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+    }
+
+    inline bool isIdentifierByte(unsigned char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    size_t skipSpacesScalar(const char *data, size_t pos, size_t size)
+    {
+        while (pos < size && isSpaceByte(data[pos]))
+        {
+            pos++;
+        }
+        return pos;
+    }
+
+    size_t findNewlineScalar(const char *data, size_t pos, size_t size)
+    {
+        // memchr ja e vetorizado pela libc
+        const void *found = pos < size ? std::memchr(data + pos, '\n', size - pos) : nullptr;
+        return found ? static_cast<const char *>(found) - data : size;
+    }
+
+    size_t skipIdentifierScalar(const char *data, size_t pos, size_t size)
+    {
+        while (pos < size && isIdentifierByte(data[pos]))
+        {
+            pos++;
+        }
+        return pos;
+    }
+
+#ifdef SIMD_SCAN_X86
+    // Comparacoes com sinal: bytes >= 0x80 ficam negativos e caem fora de
+    // qualquer faixa ASCII, como esperado.
+    __attribute__((target("sse2"))) inline __m128i inRange16(__m128i v, char lo, char hi)
+    {
+        return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+    }
+
+    __attribute__((target("sse2"))) inline unsigned spaceMask16(__m128i v)
+    {
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+                                 _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\t')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+        return static_cast<unsigned>(_mm_movemask_epi8(m));
+    }
+
+    __attribute__((target("sse2"))) inline unsigned identifierMask16(__m128i v)
+    {
+        // 'A'-'Z' viram 'a'-'z' com o bit 0x20
+        __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        __m128i m = _mm_or_si128(_mm_or_si128(inRange16(lower, 'a', 'z'), inRange16(v, '0', '9')),
+                                 _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+        return static_cast<unsigned>(_mm_movemask_epi8(m));
+    }
+
+    __attribute__((target("sse2"))) size_t skipSpacesSse2(const char *data, size_t pos, size_t size)
+    {
+        while (pos + 16 <= size)
+        {
+            unsigned miss = ~spaceMask16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos))) & 0xFFFFu;
+            if (miss)
+            {
+                return pos + __builtin_ctz(miss);
+            }
+            pos += 16;
+        }
+        return skipSpacesScalar(data, pos, size);
+    }
+
+    __attribute__((target("sse2"))) size_t findNewlineSse2(const char *data, size_t pos, size_t size)
+    {
+        const __m128i newline = _mm_set1_epi8('\n');
+        while (pos + 16 <= size)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+            unsigned hit = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)));
+            if (hit)
+            {
+                return pos + __builtin_ctz(hit);
+            }
+            pos += 16;
+        }
+        return findNewlineScalar(data, pos, size);
+    }
+
+    __attribute__((target("sse2"))) size_t skipIdentifierSse2(const char *data, size_t pos, size_t size)
+    {
+        while (pos + 16 <= size)
+        {
+            unsigned miss = ~identifierMask16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos))) & 0xFFFFu;
+            if (miss)
+            {
+                return pos + __builtin_ctz(miss);
+            }
+            pos += 16;
+        }
+        return skipIdentifierScalar(data, pos, size);
+    }
+
+    __attribute__((target("avx2"))) inline __m256i inRange32(__m256i v, char lo, char hi)
+    {
+        return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v));
+    }
+
+    __attribute__((target("avx2"))) size_t skipSpacesAvx2(const char *data, size_t pos, size_t size)
+    {
+        while (pos + 32 <= size)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+            __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))),
+                                        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+            unsigned miss = ~static_cast<unsigned>(_mm256_movemask_epi8(m));
+            if (miss)
+            {
+                return pos + __builtin_ctz(miss);
+            }
+            pos += 32;
+        }
+        return skipSpacesSse2(data, pos, size);
+    }
+
+    __attribute__((target("avx2"))) size_t findNewlineAvx2(const char *data, size_t pos, size_t size)
+    {
+        const __m256i newline = _mm256_set1_epi8('\n');
+        while (pos + 32 <= size)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+            unsigned hit = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline)));
+            if (hit)
+            {
+                return pos + __builtin_ctz(hit);
+            }
+            pos += 32;
+        }
+        return findNewlineSse2(data, pos, size);
+    }
+
+    __attribute__((target("avx2"))) size_t skipIdentifierAvx2(const char *data, size_t pos, size_t size)
+    {
+        while (pos + 32 <= size)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+            __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+            __m256i m = _mm256_or_si256(_mm256_or_si256(inRange32(lower, 'a', 'z'), inRange32(v, '0', '9')),
+                                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+            unsigned miss = ~static_cast<unsigned>(_mm256_movemask_epi8(m));
+            if (miss)
+            {
+                return pos + __builtin_ctz(miss);
+            }
+            pos += 32;
+        }
+        return skipIdentifierSse2(data, pos, size);
+    }
+#endif
+
+    struct Kernels
+    {
+        size_t (*skipSpaces)(const char *, size_t, size_t);
+        size_t (*findNewline)(const char *, size_t, size_t);
+        size_t (*skipIdentifier)(const char *, size_t, size_t);
+        const char *level;
+    };
+
+    // Implementacoes que a CPU suporta, da mais larga para a escalar
+    size_t supportedKernels(Kernels *out)
+    {
+        size_t count = 0;
+#ifdef SIMD_SCAN_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            out[count++] = {skipSpacesAvx2, findNewlineAvx2, skipIdentifierAvx2, "avx2"};
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            out[count++] = {skipSpacesSse2, findNewlineSse2, skipIdentifierSse2, "sse2"};
+        }
+#endif
+        out[count++] = {skipSpacesScalar, findNewlineScalar, skipIdentifierScalar, "scalar"};
+        return count;
+    }
+
+    Kernels selectKernels()
+    {
+        Kernels supported[3];
+        supportedKernels(supported);
+        return supported[0];
+    }
+
+    Kernels kernels = selectKernels();
+}
+
+size_t skipSpaces(const char *data, size_t pos, size_t size)
+{
+    return kernels.skipSpaces(data, pos, size);
+}
+
+size_t findNewline(const char *data, size_t pos, size_t size)
+{
+    return kernels.findNewline(data, pos, size);
+}
+
+size_t skipIdentifier(const char *data, size_t pos, size_t size)
+{
+    return kernels.skipIdentifier(data, pos, size);
+}
+
+const char *simdScanLevel()
+{
+    return kernels.level;
+}
+
+bool setSimdScanLevel(const char *level)
+{
+    Kernels supported[3];
+    size_t count = supportedKernels(supported);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (std::strcmp(supported[i].level, level) == 0)
+        {
+            kernels = supported[i];
+            return true;
+        }
+    }
+    return false;
+}
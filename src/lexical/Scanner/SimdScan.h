@@ -0,0 +1,28 @@
+#ifndef SIMD_SCAN_H
+#define SIMD_SCAN_H
+
+#include <cstddef>
+
+// Varreduras em bloco usadas pelo Scanner nos trechos mais longos do fonte.
+// Cada funcao recebe o buffer, a posicao inicial e o tamanho, e devolve a
+// primeira posicao que nao pertence a sequencia (ou size). A implementacao
+// (AVX2, SSE2 ou escalar) e escolhida uma vez, conforme a CPU.
+
+// Primeiro caractere que nao e ' ', '\t', '\r' ou '\n'
+size_t skipSpaces(const char *data, size_t pos, size_t size);
+
+// Primeiro '\n' a partir de pos
+size_t findNewline(const char *data, size_t pos, size_t size);
+
+// Primeiro caractere fora de [A-Za-z0-9_]
+size_t skipIdentifier(const char *data, size_t pos, size_t size);
+
+// Nome da implementacao escolhida ("avx2", "sse2" ou "scalar")
+const char *simdScanLevel();
+
+// Troca a implementacao por outra que a CPU suporte, para comparar as versoes
+// (bench/); false se ela nao esta disponivel. Nao chamar com algum Scanner
+// lexando.
+bool setSimdScanLevel(const char *level);
+
+#endif
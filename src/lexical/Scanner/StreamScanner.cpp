@@ -0,0 +1,113 @@
+#include "Scanner.h"
+#include "SimdScan.h"
+#include <stdexcept>
+
+// Tokens por lote entregues ao TokenCursor
+constexpr size_t STREAM_BATCH_TOKENS = 256;
+
+// Leitura em streaming. Espacos e comentarios sao pulados aqui, antes de
+// marcar o inicio do token, para que nao precisem caber na janela. Se o motor
+// chegar ao fim da janela antes do fim do fluxo, o token pode continuar no
+// proximo bloco: a janela e recarregada a partir do inicio dele e o token e
+// lexado de novo, o que e seguro porque lexar a partir do inicio de um token
+// e deterministico.
+//
+// Com canRefill falso (tokens anteriores do lote ainda apontam para a janela)
+// o Scanner para antes do token que precisaria de mais bytes e devolve NONE.
+Token Scanner::nextStreamToken(bool canRefill)
+{
+    while (true)
+    {
+        bool inComment = false;
+        size_t commentStart = pos;
+        while (true)
+        {
+            if (inComment)
+            {
+                size_t newline = findNewline(sourceBuffer.data(), pos, limit);
+                if (newline < limit)
+                {
+                    pos = newline + 1;
+                    inComment = false;
+                    continue;
+                }
+                pos = limit;
+            }
+            else
+            {
+                pos = skipSpaces(sourceBuffer.data(), pos, limit);
+                if (pos < limit && sourceBuffer[pos] == '#')
+                {
+                    commentStart = pos++;
+                    inComment = true;
+                    continue;
+                }
+                if (pos < limit)
+                {
+                    break;
+                }
+            }
+
+            // A janela acabou no meio de espacos ou de um comentario
+            if (stream->atEnd())
+            {
+                break;
+            }
+            if (!canRefill)
+            {
+                pos = inComment ? commentStart : pos;
+                return makeToken(TokenType::NONE, pos, pos);
+            }
+            refillStream(pos);
+        }
+
+        size_t tokenStart = pos;
+        Token token = engine == ScannerEngine::TABLE ? nextTokenTable() : nextTokenSwitch();
+        if (token.getType() != TokenType::NONE || stream->atEnd())
+        {
+            return token;
+        }
+
+        if (!canRefill)
+        {
+            pos = tokenStart;
+            return makeToken(TokenType::NONE, pos, pos);
+        }
+        refillStream(tokenStart);
+    }
+}
+
+// Descarta a janela antes de resumeAt, le mais bytes e continua dali
+void Scanner::refillStream(size_t resumeAt)
+{
+    lineIndex.discard(sourceBuffer.data(), resumeAt);
+    stream->refill(resumeAt);
+    sourceBuffer = SourceBuffer::view(stream->data(), stream->size());
+    base = stream->base();
+    pos = 0;
+    limit = stream->size();
+    if (base + limit > MAX_SOURCE_SIZE)
+    {
+        throw std::length_error("stream input passes Scanner::MAX_SOURCE_SIZE (32-bit offsets)");
+    }
+}
+
+bool Scanner::refill(TokenBuffer &batch)
+{
+    batch.clear();
+    while (batch.size() < STREAM_BATCH_TOKENS)
+    {
+        // So o primeiro token do lote pode recarregar a janela: os demais
+        // apontam para bytes que precisam continuar nela
+        Token token = stream ? nextStreamToken(batch.size() == 0) : nextToken();
+        if (token.getType() == TokenType::NONE)
+        {
+            break;
+        }
+        batch.push(token, true);
+    }
+    batch.source = sourceBuffer.data();
+    batch.sourceBase = static_cast<uint32_t>(base);
+    batch.endOffset = static_cast<uint32_t>(base + limit);
+    return batch.size() > 0;
+}
@@ -0,0 +1,327 @@
+#include "Scanner.h"
+#include "SimdScan.h"
+#include <array>
+
+// Motor alternativo do Scanner: um DFA com tabela de classes de caractere e
+// tabela de transicoes densa. Cada estado olha o proximo caractere sem
+// consumi-lo (lookahead explicito) e decide entre avancar ou emitir o token,
+// entao nunca e preciso voltar caracteres como o back() do motor com switch.
+// A sequencia de tokens e os erros sao os mesmos do nextToken() original.
+
+namespace
+{
+    enum CharClass : uint8_t
+    {
+        C_LETTER,
+        C_LETTER_E, // 'E' e 'e' tambem iniciam expoentes
+        C_DIGIT,
+        C_UNDERSCORE,
+        C_SPACE,
+        C_NEWLINE,
+        C_EQUAL,
+        C_LESS,
+        C_GREATER,
+        C_BANG,
+        C_COLON,
+        C_DOT,
+        C_SEMICOLON,
+        C_DELIMITER, // ( ) ,
+        C_SIGN,      // + -
+        C_MULT,      // * /
+        C_HASH,
+        C_OTHER,
+        C_EOF,
+        CLASS_COUNT
+    };
+
+    // S_START e S_COMMENT vem primeiro: enquanto estiver neles o inicio do
+    // lexema acompanha a posicao atual.
+    enum State : uint8_t
+    {
+        S_START,
+        S_COMMENT,
+        S_IDENT,
+        S_INT,
+        S_FRAC,        // depois de '.', espera digito ou expoente
+        S_EXP_DIGIT,   // ultimo caractere foi digito
+        S_EXP_LETTER,  // ultimo caractere foi 'E'/'e'
+        S_EXP_DIGITS,
+        S_DOT,
+        S_COLON,
+        S_ASSIGN_DONE,
+        S_DELIMITER,
+        S_REL_EQUAL,   // '='
+        S_REL_LESS,    // '<'
+        S_REL_OTHER,   // '>' e '!'
+        S_REL_WITH_EQ, // "<=", ">=", "==", "!="
+        S_NOT_EQUAL_DONE,
+        S_ADD,
+        S_MULT,
+        STATE_COUNT
+    };
+
+    // Valores a partir de A_BASE na tabela sao acoes em vez de estados
+    enum Action : uint8_t
+    {
+        A_BASE = 64,
+        A_END = A_BASE, // fim do arquivo, inclusive no meio de um token
+        A_WORD,
+        A_NUMBER,
+        A_FLOAT,
+        A_DELIMITER,
+        A_DELIMITER_SKIP, // emite e descarta o caractere seguinte
+        A_ASSIGNMENT,
+        A_EQUAL,
+        A_REL,
+        A_REL_SKIP,
+        A_LOGICAL,
+        A_ADD,
+        A_MULT,
+        A_FORBIDDEN,
+        A_MALFORMED,
+    };
+
+    constexpr std::array<uint8_t, 256> buildCharClass()
+    {
+        std::array<uint8_t, 256> table{};
+        for (int c = 0; c < 256; c++)
+        {
+            table[c] = C_OTHER;
+        }
+        for (int c = 'a'; c <= 'z'; c++)
+        {
+            table[c] = C_LETTER;
+            table[c - 'a' + 'A'] = C_LETTER;
+        }
+        table['e'] = table['E'] = C_LETTER_E;
+        for (int c = '0'; c <= '9'; c++)
+        {
+            table[c] = C_DIGIT;
+        }
+        table['_'] = C_UNDERSCORE;
+        table[' '] = table['\t'] = table['\r'] = C_SPACE;
+        table['\n'] = C_NEWLINE;
+        table['='] = C_EQUAL;
+        table['<'] = C_LESS;
+        table['>'] = C_GREATER;
+        table['!'] = C_BANG;
+        table[':'] = C_COLON;
+        table['.'] = C_DOT;
+        table[';'] = C_SEMICOLON;
+        table['('] = table[')'] = table[','] = C_DELIMITER;
+        table['+'] = table['-'] = C_SIGN;
+        table['*'] = table['/'] = C_MULT;
+        table['#'] = C_HASH;
+        return table;
+    }
+
+    using TransitionTable = std::array<std::array<uint8_t, CLASS_COUNT>, STATE_COUNT>;
+
+    constexpr void fill(TransitionTable &table, uint8_t state, uint8_t value)
+    {
+        for (int c = 0; c < CLASS_COUNT; c++)
+        {
+            table[state][c] = value;
+        }
+    }
+
+    constexpr TransitionTable buildTransitions()
+    {
+        TransitionTable t{};
+
+        auto &start = t[S_START];
+        fill(t, S_START, A_FORBIDDEN);
+        start[C_SPACE] = start[C_NEWLINE] = S_START;
+        start[C_LETTER] = start[C_LETTER_E] = S_IDENT;
+        start[C_DIGIT] = S_INT;
+        start[C_EQUAL] = S_REL_EQUAL;
+        start[C_LESS] = S_REL_LESS;
+        start[C_GREATER] = start[C_BANG] = S_REL_OTHER;
+        start[C_COLON] = S_COLON;
+        start[C_DOT] = S_DOT;
+        start[C_SEMICOLON] = start[C_DELIMITER] = S_DELIMITER;
+        start[C_SIGN] = S_ADD;
+        start[C_MULT] = S_MULT;
+        start[C_HASH] = S_COMMENT;
+        start[C_EOF] = A_END;
+
+        // Comentario vai ate o '\n', inclusive
+        fill(t, S_COMMENT, S_COMMENT);
+        t[S_COMMENT][C_NEWLINE] = S_START;
+        t[S_COMMENT][C_EOF] = A_END;
+
+        fill(t, S_IDENT, A_WORD);
+        t[S_IDENT][C_LETTER] = t[S_IDENT][C_LETTER_E] = t[S_IDENT][C_DIGIT] = t[S_IDENT][C_UNDERSCORE] = S_IDENT;
+        t[S_IDENT][C_EOF] = A_END;
+
+        fill(t, S_INT, A_NUMBER);
+        t[S_INT][C_DIGIT] = S_INT;
+        t[S_INT][C_DOT] = S_FRAC;
+        t[S_INT][C_EOF] = A_END;
+
+        fill(t, S_FRAC, A_MALFORMED);
+        t[S_FRAC][C_DIGIT] = S_EXP_DIGIT;
+        t[S_FRAC][C_LETTER_E] = S_EXP_LETTER;
+        t[S_FRAC][C_EOF] = A_END;
+
+        fill(t, S_EXP_DIGIT, A_FLOAT);
+        t[S_EXP_DIGIT][C_DIGIT] = t[S_EXP_DIGIT][C_SIGN] = S_EXP_DIGITS;
+        t[S_EXP_DIGIT][C_EOF] = A_END;
+
+        fill(t, S_EXP_LETTER, A_MALFORMED);
+        t[S_EXP_LETTER][C_DIGIT] = t[S_EXP_LETTER][C_SIGN] = S_EXP_DIGITS;
+        t[S_EXP_LETTER][C_EOF] = A_END;
+
+        fill(t, S_EXP_DIGITS, A_FLOAT);
+        t[S_EXP_DIGITS][C_DIGIT] = S_EXP_DIGITS;
+        t[S_EXP_DIGITS][C_EOF] = A_END;
+
+        fill(t, S_DOT, A_DELIMITER);
+        t[S_DOT][C_DIGIT] = t[S_DOT][C_LETTER_E] = S_FRAC;
+        t[S_DOT][C_EOF] = A_END;
+
+        fill(t, S_COLON, A_DELIMITER);
+        t[S_COLON][C_EQUAL] = S_ASSIGN_DONE;
+        t[S_COLON][C_EOF] = A_END;
+
+        fill(t, S_ASSIGN_DONE, A_ASSIGNMENT);
+
+        // ( ) , ; descartam o caractere seguinte, exceto operadores relacionais
+        fill(t, S_DELIMITER, A_DELIMITER_SKIP);
+        t[S_DELIMITER][C_EQUAL] = t[S_DELIMITER][C_LESS] = t[S_DELIMITER][C_GREATER] = t[S_DELIMITER][C_BANG] = A_DELIMITER;
+        t[S_DELIMITER][C_EOF] = A_END;
+
+        fill(t, S_REL_EQUAL, A_LOGICAL);
+        t[S_REL_EQUAL][C_EQUAL] = S_REL_WITH_EQ;
+        t[S_REL_EQUAL][C_SPACE] = t[S_REL_EQUAL][C_NEWLINE] = t[S_REL_EQUAL][C_DIGIT] = A_EQUAL;
+        t[S_REL_EQUAL][C_EOF] = A_END;
+
+        fill(t, S_REL_LESS, A_LOGICAL);
+        t[S_REL_LESS][C_EQUAL] = S_REL_WITH_EQ;
+        t[S_REL_LESS][C_GREATER] = S_NOT_EQUAL_DONE;
+        t[S_REL_LESS][C_SPACE] = t[S_REL_LESS][C_NEWLINE] = t[S_REL_LESS][C_DIGIT] = A_REL;
+        t[S_REL_LESS][C_EOF] = A_END;
+
+        fill(t, S_REL_OTHER, A_LOGICAL);
+        t[S_REL_OTHER][C_EQUAL] = S_REL_WITH_EQ;
+        t[S_REL_OTHER][C_SPACE] = t[S_REL_OTHER][C_NEWLINE] = t[S_REL_OTHER][C_DIGIT] = A_REL;
+        t[S_REL_OTHER][C_EOF] = A_END;
+
+        // Depois de "<=" etc. o caractere seguinte e descartado, salvo outro '='
+        fill(t, S_REL_WITH_EQ, A_REL_SKIP);
+        t[S_REL_WITH_EQ][C_EQUAL] = A_REL;
+        t[S_REL_WITH_EQ][C_EOF] = A_END;
+
+        fill(t, S_NOT_EQUAL_DONE, A_REL);
+
+        fill(t, S_ADD, A_ADD);
+        t[S_ADD][C_EOF] = A_END;
+
+        fill(t, S_MULT, A_MULT);
+        t[S_MULT][C_EOF] = A_END;
+
+        return t;
+    }
+
+    constexpr std::array<uint8_t, 256> charClass = buildCharClass();
+    constexpr TransitionTable transition = buildTransitions();
+
+    static_assert(static_cast<int>(STATE_COUNT) <= static_cast<int>(A_BASE), "estados e acoes compartilham a tabela");
+}
+
+Token Scanner::nextTokenTable()
+{
+    const char *source = sourceBuffer.data();
+    const size_t size = limit;
+    size_t p = pos;
+    size_t start = p;
+    uint8_t s = S_START;
+    uint8_t next;
+
+    while (true)
+    {
+        uint8_t cls = p < size ? charClass[static_cast<unsigned char>(source[p])] : static_cast<uint8_t>(C_EOF);
+        next = transition[s][cls];
+        if (next >= A_BASE)
+        {
+            break;
+        }
+        if (s <= S_COMMENT)
+        {
+            start = p;
+        }
+        s = next;
+        p++;
+
+        // Sequencias longas sao puladas em bloco pelos kernels SIMD
+        if (s == S_IDENT)
+        {
+            p = skipIdentifier(source, p, size);
+        }
+        else if (s == S_COMMENT)
+        {
+            p = findNewline(source, p, size);
+        }
+        else if (s == S_START)
+        {
+            p = skipSpaces(source, p, size);
+        }
+    }
+
+    // Por padrao o lookahead nao e consumido
+    pos = p;
+
+    switch (next)
+    {
+    case A_END:
+        pos = size;
+        currentToken = makeToken(TokenType::NONE, size, size);
+        break;
+    case A_WORD:
+        currentToken = makeWordToken(start, p);
+        break;
+    case A_NUMBER:
+        currentToken = makeNumberToken(TokenType::NUMBER, start, p);
+        break;
+    case A_FLOAT:
+        currentToken = makeNumberToken(TokenType::FLOAT_NUMBER, start, p);
+        break;
+    case A_DELIMITER:
+        currentToken = makePunctuatorToken(TokenType::DELIMITER, start, p);
+        break;
+    case A_DELIMITER_SKIP:
+        pos = p + 1;
+        currentToken = makePunctuatorToken(TokenType::DELIMITER, start, p);
+        break;
+    case A_ASSIGNMENT:
+        currentToken = makePunctuatorToken(TokenType::ASSIGNMENT, start, p);
+        break;
+    case A_EQUAL:
+        currentToken = makeToken(TokenType::EQUAL_OPERATOR, start, p);
+        break;
+    case A_REL:
+        currentToken = makeToken(TokenType::REL_OPERATOR, start, p);
+        break;
+    case A_REL_SKIP:
+        pos = p + 1;
+        currentToken = makeToken(TokenType::REL_OPERATOR, start, p);
+        break;
+    case A_LOGICAL:
+        currentToken = makeToken(TokenType::LOGICAL_OPERATOR, start, p);
+        break;
+    case A_ADD:
+        currentToken = makeToken(TokenType::ADD_OPERATOR, start, p);
+        break;
+    case A_MULT:
+        currentToken = makeToken(TokenType::MULT_OPERATOR, start, p);
+        break;
+    case A_FORBIDDEN:
+        pos = p + 1;
+        currentToken = lexicalError(DiagnosticCode::FORBIDDEN_SYMBOL, p, p + 1);
+        break;
+    default:
+        currentToken = lexicalError(DiagnosticCode::MISSING_EXPONENT_DIGITS, start, p);
+        break;
+    }
+    return currentToken;
+}
@@ -0,0 +1,129 @@
+#include "TokenPipeline.h"
+#include <stdexcept>
+#include <utility>
+
+// Voltas com yield antes de dormir: o outro lado costuma liberar o anel logo
+constexpr int PIPELINE_SPINS = 64;
+
+TokenPipeline::TokenPipeline(Scanner &scanner)
+    : scanner(scanner), head(0), tail(0), finished(false), stopping(false), sleepers(0), endOffset(0)
+{
+    if (scanner.isStreaming())
+    {
+        throw std::logic_error("TokenPipeline needs the whole source in memory");
+    }
+    producer = std::thread(&TokenPipeline::produce, this);
+}
+
+TokenPipeline::~TokenPipeline()
+{
+    // O consumidor pode parar antes do fim (erro de sintaxe, por exemplo)
+    stopping.store(true);
+    wake();
+    if (producer.joinable())
+    {
+        producer.join();
+    }
+}
+
+void TokenPipeline::finish()
+{
+    TokenBuffer rest;
+    while (refill(rest))
+    {
+    }
+    if (producer.joinable())
+    {
+        producer.join();
+    }
+}
+
+// As escritas em head, tail, finished e stopping e as leituras em ready() sao
+// seq_cst: ou quem avanca ve o sleepers de quem vai dormir, ou quem vai dormir
+// ve o avanco ao testar ready() com o mutex na mao
+template <typename Ready>
+void TokenPipeline::waitUntil(const Ready &ready)
+{
+    for (int spin = 0; spin < PIPELINE_SPINS; spin++)
+    {
+        if (ready())
+        {
+            return;
+        }
+        std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    sleepers.fetch_add(1);
+    wakeup.wait(lock, ready);
+    sleepers.fetch_sub(1);
+}
+
+void TokenPipeline::wake()
+{
+    if (sleepers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeup.notify_all();
+    }
+}
+
+void TokenPipeline::produce()
+{
+    try
+    {
+        while (!stopping.load(std::memory_order_relaxed))
+        {
+            size_t next = head.load(std::memory_order_relaxed);
+            if (next - tail.load(std::memory_order_acquire) == SLOTS)
+            {
+                waitUntil([&]() { return next - tail.load() < SLOTS || stopping.load(); });
+                continue;
+            }
+
+            TokenBuffer &slot = slots[next % SLOTS];
+            if (!scanner.refill(slot))
+            {
+                endOffset = slot.endOffset;
+                break;
+            }
+            head.store(next + 1);
+            wake();
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    finished.store(true);
+    wake();
+}
+
+bool TokenPipeline::refill(TokenBuffer &batch)
+{
+    size_t next = tail.load(std::memory_order_relaxed);
+    while (head.load(std::memory_order_acquire) == next)
+    {
+        if (finished.load(std::memory_order_acquire))
+        {
+            // O produtor pode ter publicado um ultimo lote antes de terminar
+            if (head.load(std::memory_order_acquire) != next)
+            {
+                break;
+            }
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+            batch.clear();
+            batch.endOffset = endOffset;
+            return false;
+        }
+        waitUntil([&]() { return head.load() != next || finished.load(); });
+    }
+
+    // Troca os vetores: o lote ja lido volta para o anel e e reaproveitado
+    std::swap(batch, slots[next % SLOTS]);
+    tail.store(next + 1);
+    wake();
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef TOKEN_PIPELINE_H
+#define TOKEN_PIPELINE_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "Scanner.h"
+
+// Lexing e parsing em paralelo: o Scanner roda numa thread produtora e entrega
+// lotes de tokens por um anel sem locks de um produtor e um consumidor. Com o
+// anel cheio o produtor espera (backpressure), e o consumidor espera com ele
+// vazio: algumas voltas cedendo a CPU e depois dormindo numa condition
+// variable, para nao ocupar um nucleo parado. O consumidor e um TokenCursor
+// ligado ao pipeline; um erro lexico e relancado para ele na mesma ordem em
+// que o Scanner sequencial o lancaria.
+//
+// O Scanner nao pode ser usado por mais ninguem (nem locate()) enquanto o
+// pipeline existir ou ate finish(), e precisa ter o fonte inteiro em memoria
+// (nao serve para streaming).
+class TokenPipeline : public TokenSource
+{
+private:
+    static constexpr size_t SLOTS = 8;
+
+    Scanner &scanner;
+    std::array<TokenBuffer, SLOTS> slots;
+    // Contadores que so crescem; slot = contador % SLOTS. Em linhas de cache
+    // separadas para produtor e consumidor nao disputarem a mesma linha.
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    std::atomic<bool> finished;
+    std::atomic<bool> stopping;
+    // Espera bloqueante: quem vai dormir conta em sleepers, e quem avanca
+    // head, tail, finished ou stopping so pega o mutex se houver alguem
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::atomic<int> sleepers;
+    // Escritos pelo produtor antes de finished
+    std::exception_ptr error;
+    uint32_t endOffset;
+    std::thread producer;
+
+public:
+    explicit TokenPipeline(Scanner &scanner);
+    ~TokenPipeline();
+    TokenPipeline(const TokenPipeline &) = delete;
+    TokenPipeline &operator=(const TokenPipeline &) = delete;
+
+    bool refill(TokenBuffer &batch) override;
+    // Le e descarta o que o consumidor nao pegou e espera o produtor. Depois
+    // disso o Scanner volta a ser do chamador, com todos os erros lexicos do
+    // fonte (--keep-going) ou o primeiro deles relancado.
+    void finish();
+
+private:
+    void produce();
+    template <typename Ready>
+    void waitUntil(const Ready &ready);
+    void wake();
+};
+
+#endif
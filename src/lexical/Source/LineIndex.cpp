@@ -0,0 +1,50 @@
+#include "LineIndex.h"
+#include "../Scanner/SimdScan.h"
+#include <algorithm>
+
+void LineIndex::build(const char *data, size_t size)
+{
+    lineStarts.clear();
+    lineStarts.push_back(0);
+    size_t pos = findNewline(data, 0, size);
+    while (pos < size)
+    {
+        lineStarts.push_back(static_cast<uint32_t>(pos + 1));
+        pos = findNewline(data, pos + 1, size);
+    }
+    built = true;
+}
+
+SourceLocation LineIndex::locate(const char *data, size_t size, size_t offset)
+{
+    if (!built)
+    {
+        build(data, size);
+    }
+
+    // Linhas da janela que comecam em ou antes de offset
+    auto line = std::upper_bound(lineStarts.begin(), lineStarts.end(), static_cast<uint32_t>(offset - discardedBytes));
+    size_t index = line - lineStarts.begin();
+    // A primeira linha da janela pode ter comecado antes dela
+    size_t lineStart = index == 1 ? discardedLineStart : discardedBytes + lineStarts[index - 1];
+    return {discardedRows + static_cast<int>(index), static_cast<int>(offset - lineStart) + 1};
+}
+
+void LineIndex::discard(const char *data, size_t count)
+{
+    size_t pos = findNewline(data, 0, count);
+    while (pos < count)
+    {
+        discardedRows++;
+        discardedLineStart = discardedBytes + pos + 1;
+        pos = findNewline(data, pos + 1, count);
+    }
+    discardedBytes += count;
+    built = false;
+}
+
+void LineIndex::reset()
+{
+    lineStarts.clear();
+    built = false;
+}
@@ -0,0 +1,41 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+struct SourceLocation
+{
+    int row;
+    int col;
+};
+
+// Converte offsets de bytes em linha/coluna sob demanda. A tabela com o
+// inicio de cada linha so e montada na primeira consulta, entao o Scanner
+// nao paga nada por posicao enquanto nao houver diagnostico.
+class LineIndex
+{
+private:
+    std::vector<uint32_t> lineStarts;
+    bool built = false;
+    // Fontes em streaming: bytes que ja sairam da janela, as linhas que eles
+    // fecharam e o offset do inicio da ultima delas
+    size_t discardedBytes = 0;
+    int discardedRows = 0;
+    size_t discardedLineStart = 0;
+
+public:
+    // Posicao do byte em offset no formato de todos os erros, lexicos e
+    // sintaticos: linha e coluna contadas a partir de 1, no inicio do token
+    // data/size e a janela atual; offset e absoluto e precisa estar nela
+    SourceLocation locate(const char *data, size_t size, size_t offset);
+    // Os count primeiros bytes de data vao ser descartados da janela
+    void discard(const char *data, size_t count);
+    void reset();
+
+private:
+    void build(const char *data, size_t size);
+};
+
+#endif
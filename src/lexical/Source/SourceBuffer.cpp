@@ -0,0 +1,150 @@
+#include "SourceBuffer.h"
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SOURCE_BUFFER_HAS_MMAP 1
+#endif
+
+SourceBuffer::SourceBuffer() : bytes(nullptr), length(0), mapping(nullptr) {}
+
+SourceBuffer::SourceBuffer(SourceBuffer &&other) noexcept
+    : bytes(other.bytes), length(other.length), mapping(other.mapping), owned(std::move(other.owned))
+{
+    // O vector movido mantem o mesmo bloco de memoria, entao bytes continua valido
+    other.bytes = nullptr;
+    other.length = 0;
+    other.mapping = nullptr;
+}
+
+SourceBuffer &SourceBuffer::operator=(SourceBuffer &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        bytes = other.bytes;
+        length = other.length;
+        mapping = other.mapping;
+        owned = std::move(other.owned);
+        other.bytes = nullptr;
+        other.length = 0;
+        other.mapping = nullptr;
+    }
+    return *this;
+}
+
+SourceBuffer::~SourceBuffer()
+{
+    release();
+}
+
+void SourceBuffer::release()
+{
+#ifdef SOURCE_BUFFER_HAS_MMAP
+    if (mapping != nullptr)
+    {
+        munmap(mapping, length);
+    }
+#endif
+    mapping = nullptr;
+    bytes = nullptr;
+    length = 0;
+    owned.clear();
+}
+
+SourceBuffer SourceBuffer::fromFile(const std::string &path, bool useMmap)
+{
+    SourceBuffer buffer;
+
+#ifdef SOURCE_BUFFER_HAS_MMAP
+    if (useMmap)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Unable to open file");
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+        {
+            void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+                madvise(mapped, info.st_size, MADV_WILLNEED);
+                close(fd);
+
+                buffer.mapping = mapped;
+                buffer.bytes = static_cast<const char *>(mapped);
+                buffer.length = info.st_size;
+                return buffer;
+            }
+        }
+        close(fd);
+        // Arquivo vazio, pipe ou mmap indisponivel: cai para a leitura comum
+    }
+#endif
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Unable to open file");
+    }
+
+    // Le direto para o buffer final, sem a string intermediaria
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (size > 0)
+    {
+        buffer.owned.resize(size);
+        file.read(buffer.owned.data(), size);
+        buffer.owned.resize(file.gcount());
+    }
+    else
+    {
+        buffer.owned.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    buffer.bytes = buffer.owned.data();
+    buffer.length = buffer.owned.size();
+    return buffer;
+}
+
+SourceBuffer SourceBuffer::fromString(const std::string &text)
+{
+    SourceBuffer buffer;
+    buffer.owned.assign(text.begin(), text.end());
+    buffer.bytes = buffer.owned.data();
+    buffer.length = buffer.owned.size();
+    return buffer;
+}
+
+SourceBuffer SourceBuffer::view(const char *data, size_t size)
+{
+    SourceBuffer buffer;
+    buffer.bytes = data;
+    buffer.length = size;
+    return buffer;
+}
+
+void SourceBuffer::replace(size_t offset, size_t removed, std::string_view inserted)
+{
+    if (bytes != owned.data())
+    {
+        std::vector<char> copy(bytes, bytes + length);
+        release();
+        owned = std::move(copy);
+    }
+
+    owned.erase(owned.begin() + offset, owned.begin() + offset + removed);
+    owned.insert(owned.begin() + offset, inserted.begin(), inserted.end());
+    bytes = owned.data();
+    length = owned.size();
+}
@@ -0,0 +1,46 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+// Bytes do programa fonte. Por padrao o arquivo e mapeado em memoria (mmap,
+// somente leitura) e o Scanner le direto do mapeamento, sem copias. Fontes em
+// memoria, ou sistemas sem mmap, usam um buffer proprio.
+class SourceBuffer
+{
+private:
+    const char *bytes;
+    size_t length;
+    void *mapping;
+    std::vector<char> owned;
+
+public:
+    SourceBuffer();
+    SourceBuffer(SourceBuffer &&other) noexcept;
+    SourceBuffer &operator=(SourceBuffer &&other) noexcept;
+    SourceBuffer(const SourceBuffer &) = delete;
+    SourceBuffer &operator=(const SourceBuffer &) = delete;
+    ~SourceBuffer();
+
+    static SourceBuffer fromFile(const std::string &path, bool useMmap = true);
+    static SourceBuffer fromString(const std::string &text);
+    // Visao sem posse sobre bytes de outro buffer, que precisa sobreviver a ela
+    static SourceBuffer view(const char *data, size_t size);
+
+    // Troca removed bytes a partir de offset por inserted. Um arquivo mapeado
+    // e copiado para um buffer proprio na primeira edicao.
+    void replace(size_t offset, size_t removed, std::string_view inserted);
+
+    const char *data() const { return bytes; }
+    size_t size() const { return length; }
+    bool isMapped() const { return mapping != nullptr; }
+    char operator[](size_t i) const { return bytes[i]; }
+
+private:
+    void release();
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "StreamSource.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+
+StreamSource::StreamSource(int fd, size_t windowSize) : fd(fd), window(windowSize), filled(0), discarded(0), eof(false) {}
+
+size_t StreamSource::refill(size_t keepFrom)
+{
+    if (keepFrom > 0)
+    {
+        std::memmove(window.data(), window.data() + keepFrom, filled - keepFrom);
+        filled -= keepFrom;
+        discarded += keepFrom;
+    }
+    if (filled == window.size())
+    {
+        // Um token ocupa a janela inteira
+        window.resize(window.size() * 2);
+    }
+
+    while (!eof)
+    {
+        ssize_t count = read(fd, window.data() + filled, window.size() - filled);
+        if (count > 0)
+        {
+            filled += count;
+            return count;
+        }
+        if (count == 0)
+        {
+            eof = true;
+        }
+        else if (errno != EINTR)
+        {
+            throw std::runtime_error("Unable to read input");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,37 @@
+#ifndef STREAM_SOURCE_H
+#define STREAM_SOURCE_H
+
+#include <cstddef>
+#include <vector>
+
+// Fonte lida aos poucos de um descritor (stdin, pipe, socket) para uma janela
+// de tamanho fixo. Os bytes ja consumidos sao descartados a cada recarga, entao
+// a memoria nao depende do tamanho da entrada; a janela so cresce se um unico
+// token for maior que ela.
+class StreamSource
+{
+private:
+    int fd;
+    std::vector<char> window;
+    size_t filled;
+    // Offset no fluxo do primeiro byte da janela
+    size_t discarded;
+    bool eof;
+
+public:
+    static constexpr size_t DEFAULT_WINDOW = 64 * 1024;
+
+    explicit StreamSource(int fd, size_t windowSize = DEFAULT_WINDOW);
+
+    // Descarta os bytes antes de keepFrom (posicao na janela), move o resto
+    // para o inicio e le mais do descritor. Devolve quantos bytes foram lidos;
+    // 0 so no fim do fluxo.
+    size_t refill(size_t keepFrom);
+
+    const char *data() const { return window.data(); }
+    size_t size() const { return filled; }
+    size_t base() const { return discarded; }
+    bool atEnd() const { return eof; }
+};
+
+#endif
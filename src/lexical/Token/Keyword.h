@@ -0,0 +1,143 @@
+#ifndef KEYWORD_H
+#define KEYWORD_H
+
+#include <cstdint>
+#include <string_view>
+
+// Palavra reservada ou pontuacao de um token, para o Parser decidir as
+// producoes comparando inteiros em vez de texto. NONE nos demais tokens.
+enum class Keyword : uint8_t
+{
+    NONE,
+    PROGRAM,
+    VAR,
+    INTEGER,
+    REAL,
+    BOOLEAN,
+    PROCEDURE,
+    BEGIN,
+    END,
+    IF,
+    THEN,
+    ELSE,
+    WHILE,
+    DO,
+    NOT,
+    AND, // "and" ou "AND": operador multiplicativo
+    OR,  // "or" ou "OR": operador aditivo
+    TRUE,
+    FALSE,
+
+    // Pontuacao (tokens DELIMITER e ASSIGNMENT)
+    SEMICOLON,
+    COMMA,
+    DOT,
+    COLON,
+    LEFT_PAREN,
+    RIGHT_PAREN,
+    ASSIGN,
+};
+
+// Grafia de cada Keyword, na ordem do enum, para mensagens de erro
+constexpr std::string_view keywordText(Keyword keyword)
+{
+    constexpr std::string_view texts[] = {
+        "", "program", "var", "integer", "real", "boolean", "procedure", "begin", "end",
+        "if", "then", "else", "while", "do", "not", "and", "or", "true", "false",
+        ";", ",", ".", ":", "(", ")", ":=",
+    };
+    return texts[static_cast<uint8_t>(keyword)];
+}
+
+// Classifica um lexema de identificador sem alocar: o tamanho e o primeiro
+// caractere ja determinam o unico candidato possivel, que e confirmado com
+// uma so comparacao. As variantes em maiusculas ficam aqui tambem.
+constexpr Keyword classifyKeyword(std::string_view word)
+{
+    auto is = [word](std::string_view candidate, Keyword keyword) {
+        return word == candidate ? keyword : Keyword::NONE;
+    };
+
+    switch (word.size())
+    {
+    case 2:
+        switch (word[0])
+        {
+        case 'i': return is("if", Keyword::IF);
+        case 'd': return is("do", Keyword::DO);
+        case 'o': return is("or", Keyword::OR);
+        case 'O': return is("OR", Keyword::OR);
+        }
+        break;
+    case 3:
+        switch (word[0])
+        {
+        case 'v': return is("var", Keyword::VAR);
+        case 'e': return is("end", Keyword::END);
+        case 'n': return is("not", Keyword::NOT);
+        case 'a': return is("and", Keyword::AND);
+        case 'A': return is("AND", Keyword::AND);
+        }
+        break;
+    case 4:
+        switch (word[0])
+        {
+        case 'r': return is("real", Keyword::REAL);
+        case 't': return word[1] == 'h' ? is("then", Keyword::THEN) : is("true", Keyword::TRUE);
+        case 'e': return is("else", Keyword::ELSE);
+        }
+        break;
+    case 5:
+        switch (word[0])
+        {
+        case 'b': return is("begin", Keyword::BEGIN);
+        case 'w': return is("while", Keyword::WHILE);
+        case 'f': return is("false", Keyword::FALSE);
+        }
+        break;
+    case 7:
+        switch (word[0])
+        {
+        case 'p': return is("program", Keyword::PROGRAM);
+        case 'i': return is("integer", Keyword::INTEGER);
+        case 'b': return is("boolean", Keyword::BOOLEAN);
+        }
+        break;
+    case 9:
+        return is("procedure", Keyword::PROCEDURE);
+    }
+    return Keyword::NONE;
+}
+
+// Lexema de um DELIMITER ou ASSIGNMENT
+constexpr Keyword classifyPunctuator(std::string_view text)
+{
+    if (text.size() == 2)
+    {
+        return text == ":=" ? Keyword::ASSIGN : Keyword::NONE;
+    }
+    switch (text.empty() ? '\0' : text[0])
+    {
+    case ';': return Keyword::SEMICOLON;
+    case ',': return Keyword::COMMA;
+    case '.': return Keyword::DOT;
+    case ':': return Keyword::COLON;
+    case '(': return Keyword::LEFT_PAREN;
+    case ')': return Keyword::RIGHT_PAREN;
+    }
+    return Keyword::NONE;
+}
+
+static_assert(classifyKeyword("procedure") == Keyword::PROCEDURE);
+static_assert(classifyKeyword("AND") == Keyword::AND);
+static_assert(classifyKeyword("Or") == Keyword::NONE);
+static_assert(classifyKeyword("begins") == Keyword::NONE);
+static_assert(classifyKeyword("true") == Keyword::TRUE);
+static_assert(classifyKeyword("then") == Keyword::THEN);
+static_assert(classifyKeyword("false") == Keyword::FALSE);
+static_assert(classifyPunctuator(":=") == Keyword::ASSIGN);
+static_assert(classifyPunctuator(")") == Keyword::RIGHT_PAREN);
+static_assert(keywordText(Keyword::ASSIGN) == ":=");
+static_assert(keywordText(Keyword::OR) == "or");
+
+#endif
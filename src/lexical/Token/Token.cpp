@@ -1,17 +1,57 @@
 #include "Token.h"
 
-Token::Token(TokenType type, const std::string &text) : type(type), text(text) {}
+Token::Token(TokenType type, std::string_view text, uint32_t offset, SymbolId symbol) : type(type), text(text), offset(offset), symbol(symbol), value{0}, keyword(Keyword::NONE) {}
 
 TokenType Token::getType() const
 {
     return type;
 }
 
-std::string Token::getText() const
+std::string_view Token::getText() const
 {
     return text;
 }
 
+uint32_t Token::getOffset() const
+{
+    return offset;
+}
+
+SymbolId Token::getSymbol() const
+{
+    return symbol;
+}
+
+NumericValue Token::getValue() const
+{
+    return value;
+}
+
+int64_t Token::getInteger() const
+{
+    return value.integer;
+}
+
+double Token::getReal() const
+{
+    return value.real;
+}
+
+void Token::setValue(NumericValue value)
+{
+    this->value = value;
+}
+
+Keyword Token::getKeyword() const
+{
+    return keyword;
+}
+
+void Token::setKeyword(Keyword keyword)
+{
+    this->keyword = keyword;
+}
+
 std::ostream &operator<<(std::ostream &os, const Token &token)
 {
     os << "Token: type: " << static_cast<int>(token.type) << ", text: " << token.text << "";
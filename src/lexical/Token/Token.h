@@ -2,7 +2,12 @@
 #define TOKEN_H
 
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <cstdint>
+
+#include "../Interner/Interner.h"
+#include "Keyword.h"
 
 enum class TokenType
 {
@@ -21,19 +26,46 @@ enum class TokenType
     REL_FUNCTION,
 
     NONE,
+    // Lexema rejeitado quando o Scanner coleta diagnosticos em vez de lancar
+    ERROR,
+};
+
+// Valor de um literal numerico, decodificado uma vez pelo Scanner: integer
+// nos tokens NUMBER, real nos FLOAT_NUMBER
+union NumericValue
+{
+    int64_t integer;
+    double real;
 };
 
 class Token
 {
     private:
         TokenType type;
-        std::string text;
+        // Lexema como visao sobre o buffer do Scanner: o token nao aloca e so
+        // e valido enquanto o Scanner que o produziu existir
+        std::string_view text;
+        // Posicao do lexema no fonte; linha/coluna sao calculadas sob demanda
+        uint32_t offset;
+        // Nome internado dos identificadores; NO_SYMBOL nos demais tokens
+        SymbolId symbol;
+        // Valor dos literais NUMBER e FLOAT_NUMBER; zero nos demais tokens
+        NumericValue value;
+        Keyword keyword;
 
     public:
-        Token(TokenType type = TokenType::NONE, const std::string &text = "");
+        Token(TokenType type = TokenType::NONE, std::string_view text = {}, uint32_t offset = 0, SymbolId symbol = NO_SYMBOL);
 
         TokenType getType() const;
-        std::string getText() const;
+        std::string_view getText() const;
+        uint32_t getOffset() const;
+        SymbolId getSymbol() const;
+        NumericValue getValue() const;
+        int64_t getInteger() const;
+        double getReal() const;
+        void setValue(NumericValue value);
+        Keyword getKeyword() const;
+        void setKeyword(Keyword keyword);
 
         friend std::ostream &operator<<(std::ostream &os, const Token &token);
     };
@@ -0,0 +1,159 @@
+#include "TokenBuffer.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+void TokenBuffer::reserve(size_t count, bool withSymbols)
+{
+    kinds.reserve(count);
+    keywords.reserve(count);
+    offsets.reserve(count);
+    lengths.reserve(count);
+    if (withSymbols)
+    {
+        symbols.reserve(count);
+    }
+}
+
+void TokenBuffer::push(const Token &token, bool withSymbols)
+{
+    kinds.push_back(static_cast<uint8_t>(token.getType()));
+    keywords.push_back(token.getKeyword());
+    offsets.push_back(token.getOffset());
+    lengths.push_back(static_cast<uint32_t>(token.getText().size()));
+    if (withSymbols)
+    {
+        if (isNumeric(kinds.back()))
+        {
+            symbols.push_back(static_cast<SymbolId>(literals.size()));
+            literals.push_back(token.getValue());
+        }
+        else
+        {
+            symbols.push_back(token.getSymbol());
+        }
+    }
+}
+
+void TokenBuffer::clear()
+{
+    kinds.clear();
+    keywords.clear();
+    offsets.clear();
+    lengths.clear();
+    symbols.clear();
+    literals.clear();
+}
+
+Token TokenBuffer::at(size_t index) const
+{
+    std::string_view text(source + (offsets[index] - sourceBase), lengths[index]);
+    Token token(static_cast<TokenType>(kinds[index]), text, offsets[index],
+                symbols.empty() || isNumeric(kinds[index]) ? NO_SYMBOL : symbols[index]);
+    if (!symbols.empty() && isNumeric(kinds[index]))
+    {
+        token.setValue(literals[symbols[index]]);
+    }
+    token.setKeyword(keywords[index]);
+    return token;
+}
+
+TokenCursor::TokenCursor(const TokenBuffer &buffer)
+    : buffer(&buffer), source(nullptr), first(0), index(0), limit(buffer.size())
+{
+}
+
+TokenCursor::TokenCursor(const TokenBuffer &buffer, size_t begin, size_t end)
+    : buffer(&buffer), source(nullptr), first(begin), index(begin), limit(end)
+{
+}
+
+TokenCursor::TokenCursor(TokenSource &source) : buffer(&batch), source(&source), first(0), index(0), limit(0) {}
+
+bool TokenCursor::nextBatch()
+{
+    if (source == nullptr || !source->refill(batch))
+    {
+        return false;
+    }
+    index = 0;
+    limit = batch.size();
+    return limit > 0;
+}
+
+Token TokenCursor::endToken() const
+{
+    uint32_t offset = limit < buffer->size() ? buffer->offsets[limit] : buffer->endOffset;
+    return Token(TokenType::NONE, "", offset);
+}
+
+Token TokenCursor::next()
+{
+    if (index >= limit && !nextBatch())
+    {
+        return endToken();
+    }
+    return buffer->at(index++);
+}
+
+size_t TokenCursor::read(Token *out, size_t count)
+{
+    if (index >= limit && !nextBatch())
+    {
+        out[0] = endToken();
+        return 1;
+    }
+    size_t available = std::min(count, limit - index);
+    for (size_t i = 0; i < available; i++)
+    {
+        out[i] = buffer->at(index + i);
+    }
+    index += available;
+    return available;
+}
+
+void TokenCursor::skip(size_t count)
+{
+    while (count > 0 && !atEnd())
+    {
+        size_t step = std::min(count, limit - index);
+        index += step;
+        count -= step;
+    }
+}
+
+bool TokenCursor::atEnd()
+{
+    return index >= limit && !nextBatch();
+}
+
+void TokenCursor::rewind()
+{
+    index = first;
+}
+
+TokenLookahead::TokenLookahead(TokenCursor &tokens) : tokens(tokens) {}
+
+void TokenLookahead::fill(size_t needed)
+{
+    // Cada leitura vai ate o fim do anel ou ate o que falta, o que vier antes
+    while (count < needed)
+    {
+        size_t tail = (head + count) % CAPACITY;
+        size_t space = std::min(needed - count, CAPACITY - tail);
+        count += tokens.read(&ring[tail], space);
+    }
+}
+
+__attribute__((cold, noinline)) void TokenLookahead::peekTooFar(size_t k)
+{
+    throw std::logic_error("TokenLookahead::peek(" + std::to_string(k) + ") passes MAX_PEEK");
+}
+
+void TokenLookahead::skip(size_t count)
+{
+    size_t buffered = std::min(count, this->count);
+    head = (head + buffered) % CAPACITY;
+    this->count -= buffered;
+    tokens.skip(count - buffered);
+}
@@ -0,0 +1,164 @@
+#ifndef TOKEN_BUFFER_H
+#define TOKEN_BUFFER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "../Source/LineIndex.h"
+#include "../Token/Token.h"
+
+// Sequencia de tokens em estrutura de arrays (SoA): tipo, posicao e tamanho
+// de cada lexema ficam em vetores contiguos separados. O texto nao e copiado;
+// os tokens apontam para o buffer do Scanner, que deve continuar vivo.
+class TokenBuffer
+{
+public:
+    std::vector<uint8_t> kinds;
+    // Keyword de cada token (NONE fora de palavras reservadas e pontuacao)
+    std::vector<Keyword> keywords;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+    // Opcional: vazio quando o buffer foi gerado sem ids de simbolo. Nos
+    // literais numericos guarda o indice do valor em literals.
+    std::vector<SymbolId> symbols;
+    std::vector<NumericValue> literals;
+    const char *source = nullptr;
+    // Offset no fonte do byte em source[0]; diferente de zero nos lotes de um
+    // Scanner em streaming
+    uint32_t sourceBase = 0;
+    // Offset do fim do fonte, usado no token NONE do final
+    uint32_t endOffset = 0;
+
+    void reserve(size_t count, bool withSymbols);
+    void push(const Token &token, bool withSymbols);
+    void clear();
+
+    size_t size() const { return kinds.size(); }
+    Token at(size_t index) const;
+
+    static bool isNumeric(uint8_t kind)
+    {
+        return kind == static_cast<uint8_t>(TokenType::NUMBER) || kind == static_cast<uint8_t>(TokenType::FLOAT_NUMBER);
+    }
+};
+
+// Produtor de tokens em lotes, para quando o fonte nao cabe (ou ainda nao
+// chegou) inteiro na memoria
+class TokenSource
+{
+public:
+    virtual ~TokenSource() = default;
+    // Troca o conteudo de batch pelos proximos tokens; false no fim do fonte.
+    // O texto do lote anterior deixa de ser valido.
+    virtual bool refill(TokenBuffer &batch) = 0;
+    // Linha e coluna do byte em offset enquanto ele esta no lote atual, para
+    // fontes que descartam o texto; {0, 0} quando a fonte nao sabe dizer
+    virtual SourceLocation locate(size_t) { return {0, 0}; }
+};
+
+// Percorre um TokenBuffer devolvendo um Token por vez. Depois do ultimo token
+// devolve sempre TokenType::NONE, como o Scanner faz no fim do arquivo.
+// Sobre um TokenSource os tokens vem lote a lote, e o texto de um token so
+// vale ate o fim do seu lote.
+class TokenCursor
+{
+private:
+    const TokenBuffer *buffer;
+    TokenSource *source;
+    TokenBuffer batch;
+    size_t first;
+    size_t index;
+    size_t limit;
+
+public:
+    TokenCursor(const TokenBuffer &buffer);
+    // So os tokens [begin, end) do buffer; o NONE do fim fica no offset do token end
+    TokenCursor(const TokenBuffer &buffer, size_t begin, size_t end);
+    TokenCursor(TokenSource &source);
+
+    Token next();
+    // Copia para out ate count tokens do lote atual, sem passar para o
+    // seguinte enquanto este tiver tokens. Devolve quantos copiou, sempre pelo
+    // menos um: depois do ultimo token, um TokenType::NONE.
+    size_t read(Token *out, size_t count);
+    // Tokens que ainda restam no lote atual e o k-esimo deles, sem consumir
+    size_t buffered() const { return limit - index; }
+    Token ahead(size_t k) const { return buffer->at(index + k); }
+    // Descarta os proximos count tokens sem monta-los
+    void skip(size_t count);
+    bool atEnd();
+    // So volta ao inicio do lote atual quando ligado a um TokenSource
+    void rewind();
+    // O TokenBuffer percorrido, ou nullptr quando ligado a um TokenSource
+    const TokenBuffer *wholeBuffer() const { return source == nullptr ? buffer : nullptr; }
+    // Posicao de um token do lote atual pelo TokenSource; {0, 0} sobre um
+    // TokenBuffer, que pode ser localizado depois pelo Scanner que o gerou
+    SourceLocation locate(size_t offset) { return source == nullptr ? SourceLocation{0, 0} : source->locate(offset); }
+
+private:
+    bool nextBatch();
+    Token endToken() const;
+};
+
+// Janela de lookahead sobre um TokenCursor: peek(0) e o proximo token que
+// next() devolve e peek(k) o k-esimo depois dele, ate MAX_PEEK (um k maior
+// lanca std::logic_error em vez de sobrescrever o anel). Enquanto
+// o token olhado esta no lote atual do cursor ele e lido direto dali; o anel
+// so guarda os tokens de um peek que passa para o lote seguinte de um
+// TokenSource (preenchido com TokenCursor::read, varios por chamada). Nesse
+// caso o texto dos tokens do lote anterior deixa de valer (tipo, keyword,
+// offset e simbolo continuam validos).
+class TokenLookahead
+{
+public:
+    static constexpr size_t CAPACITY = 8;
+    static constexpr size_t MAX_PEEK = CAPACITY - 1;
+
+    explicit TokenLookahead(TokenCursor &tokens);
+
+    Token peek(size_t k)
+    {
+        if (k > MAX_PEEK)
+        {
+            peekTooFar(k);
+        }
+        if (count == 0 && k < tokens.buffered())
+        {
+            return tokens.ahead(k);
+        }
+        if (k >= count)
+        {
+            fill(k + 1);
+        }
+        return ring[(head + k) % CAPACITY];
+    }
+    Token next()
+    {
+        if (count == 0)
+        {
+            return tokens.next();
+        }
+        Token token = ring[head];
+        head = (head + 1) % CAPACITY;
+        count--;
+        return token;
+    }
+    // Descarta os proximos count tokens, do anel e depois do cursor
+    void skip(size_t count);
+    const TokenBuffer *wholeBuffer() const { return tokens.wholeBuffer(); }
+    // Como TokenCursor::locate; um token de antes de um peek que trocou de
+    // lote ja nao e localizavel
+    SourceLocation locate(size_t offset) { return tokens.locate(offset); }
+
+private:
+    TokenCursor &tokens;
+    std::array<Token, CAPACITY> ring;
+    size_t head = 0;
+    size_t count = 0;
+
+    void fill(size_t needed);
+    [[noreturn]] static void peekTooFar(size_t k);
+};
+
+#endif
@@ -1,7 +1,17 @@
+#include <charconv>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unistd.h>
 #include "lexical/Scanner/Scanner.h"
+#include "lexical/Scanner/TokenPipeline.h"
 #include "lexical/Token/Token.h"
+#include "lexical/TokenBuffer/TokenBuffer.h"
 #include "parser/Parser.h"
+#include "parser/LL1/PredictiveParser.h"
+#include "parser/LL1/StaticLL1Table.h"
+#include "parser/LR/ShiftReduceParser.h"
 
 // int main()
 // {
@@ -17,34 +27,266 @@
 //     return 0;
 // }
 
-int main()
+// O lexer por tras do TokenCursor, consultado depois da analise sintatica
+// para os erros lexicos guardados (--keep-going) e para linha/coluna dos
+// erros. Com o pipeline a thread produtora termina antes, porque locate()
+// atualiza o indice de linhas do Scanner que ela usa no caminho de erro.
+struct Lexer
 {
-    Scanner sc("source_code.mc");
+    Scanner *scanner = nullptr;
+    TokenPipeline *pipeline = nullptr;
+};
 
-    // Primeiro, imprima todos os tokens gerados pelo scanner
-    std::cout << "Token sequence:" << std::endl;
-    Token tk;
-    while (true)
+// Termina o lexer e imprime os erros lexicos; true se havia algum
+static bool reportLexicalErrors(Lexer &lexer)
+{
+    if (lexer.pipeline != nullptr)
+    {
+        lexer.pipeline->finish();
+    }
+    if (lexer.scanner == nullptr || lexer.scanner->getDiagnostics().empty())
+    {
+        return false;
+    }
+    for (const Diagnostic &diagnostic : lexer.scanner->getDiagnostics())
+    {
+        std::cerr << lexer.scanner->renderDiagnostic(diagnostic) << std::endl;
+    }
+    return true;
+}
+
+// Erros lexicos tem precedencia, como na leitura com tokenizeAll: os
+// sintaticos que eles causam nao sao listados. true se houve algum erro.
+static bool reportErrors(const std::vector<SyntaxDiagnostic> &diagnostics, Lexer &lexer)
+{
+    if (reportLexicalErrors(lexer))
     {
-        tk = sc.nextToken();
-        if (tk.getType() == TokenType::NONE)
+        return true;
+    }
+    for (const SyntaxDiagnostic &diagnostic : diagnostics)
+    {
+        std::cerr << "Error: " << formatSyntaxDiagnostic(diagnostic);
+        // No streaming o parser ja guardou a posicao; nos outros modos o
+        // Scanner ainda tem o fonte inteiro
+        SourceLocation location = diagnostic.location;
+        if (location.row == 0 && lexer.scanner != nullptr)
         {
-            break;
+            location = lexer.scanner->locate(diagnostic.offset);
         }
-        std::cout << tk.getText() << " (Type: " << static_cast<int>(tk.getType()) << ")" << std::endl;
+        if (location.row != 0)
+        {
+            std::cerr << " at row " << location.row << ", col " << location.col;
+        }
+        std::cerr << std::endl;
     }
+    return !diagnostics.empty();
+}
 
-    // Reinicialize o scanner para reiniciar a leitura do arquivo
-    sc = Scanner("source_code.mc");
+// Analise sintatica sobre os tokens do cursor. Os erros sintaticos sao
+// listados todos de uma vez, com linha e coluna.
+static int compile(TokenCursor &cursor, bool showTrace, size_t errorLimit, Lexer &lexer)
+{
+    Ast ast;
+    Parser parser(cursor, ast);
+    parser.setErrorLimit(errorLimit);
+    parser.parseProgram();
+    if (showTrace)
+    {
+        parser.dumpTrace(std::cout);
+    }
 
-    // Agora, proceda para a análise sintática
-    Token firstToken = sc.nextToken();
-    std::cout << "First token: " << firstToken.getText() << std::endl;
+    if (reportErrors(parser.getDiagnostics(), lexer))
+    {
+        if (!showTrace && !parser.getDiagnostics().empty())
+        {
+            parser.dumpTrace(std::cerr);
+        }
+        return 1;
+    }
 
-    Parser parser(sc);
-    parser.parseProgram();
+    std::cout << "Compilation Successful" << std::endl;
+    return 0;
+}
+
+// Mesma analise pelo analisador preditivo (--ll1), com a tabela montada em
+// tempo de compilacao
+static int compilePredictive(TokenCursor &cursor, size_t errorLimit, Lexer &lexer)
+{
+    PredictiveParser parser(cursor, LANGUAGE_LL1_TABLE);
+    parser.setErrorLimit(errorLimit);
+    parser.parse();
+    if (reportErrors(parser.getDiagnostics(), lexer))
+    {
+        return 1;
+    }
 
     std::cout << "Compilation Successful" << std::endl;
+    return 0;
+}
+
+// Mesma analise pelo analisador ascendente LALR(1) (--lalr), com as tabelas
+// geradas de getGramatica() na partida
+static int compileShiftReduce(TokenCursor &cursor, size_t errorLimit, Lexer &lexer)
+{
+    LALRTable table = LALRTable::fromLanguageGrammar();
+    ShiftReduceParser parser(cursor, table);
+    parser.setErrorLimit(errorLimit);
+    parser.parse();
+    if (reportErrors(parser.getDiagnostics(), lexer))
+    {
+        return 1;
+    }
 
+    std::cout << "Compilation Successful" << std::endl;
     return 0;
-}
\ No newline at end of file
+}
+
+// Numero decimal sem sinal ocupando o texto todo
+static bool parseCount(std::string_view text, size_t &count)
+{
+    std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), count);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+enum class Engine
+{
+    RECURSIVE_DESCENT,
+    LL1,
+    LALR,
+};
+
+static int compile(TokenCursor &cursor, Engine engine, bool showTrace, size_t errorLimit, Lexer &lexer)
+{
+    switch (engine)
+    {
+    case Engine::LL1:
+        return compilePredictive(cursor, errorLimit, lexer);
+    case Engine::LALR:
+        return compileShiftReduce(cursor, errorLimit, lexer);
+    default:
+        return compile(cursor, showTrace, errorLimit, lexer);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    bool tableScanner = false;
+    bool keepGoing = false;
+    bool fromStdin = false;
+    bool pipelined = false;
+    bool showTrace = false;
+    size_t errorLimit = 25;
+    Engine engine = Engine::RECURSIVE_DESCENT;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--table-scanner")
+        {
+            tableScanner = true;
+        }
+        else if (arg == "--keep-going")
+        {
+            keepGoing = true;
+        }
+        else if (arg == "-")
+        {
+            fromStdin = true;
+        }
+        else if (arg == "--pipeline")
+        {
+            pipelined = true;
+        }
+        else if (arg == "--trace")
+        {
+            showTrace = true;
+        }
+        else if (arg == "--ll1")
+        {
+            engine = Engine::LL1;
+        }
+        else if (arg == "--lalr")
+        {
+            engine = Engine::LALR;
+        }
+        else if (arg == "--lalr-report")
+        {
+            LALRTable::fromLanguageGrammar().report(std::cout);
+            return 0;
+        }
+        else if (arg == "--ll1-report")
+        {
+            // A tabela gerada agora de getGramatica() deve ser a mesma que o
+            // compilador montou de GRAMATICA_LL1
+            LL1Table generated = LL1Table::fromLanguageGrammar();
+            generated.report(std::cout);
+            bool inSync = generated.view().sameEntries(LANGUAGE_LL1_TABLE);
+            std::cout << "static table: " << (inSync ? "matches getGramatica()" : "out of date, update GRAMATICA_LL1")
+                      << std::endl;
+            return inSync ? 0 : 1;
+        }
+        else if (arg == "--max-errors")
+        {
+            if (i + 1 == argc || !parseCount(argv[++i], errorLimit) || errorLimit == 0)
+            {
+                std::cerr << "usage: --max-errors N, with N a positive integer" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // "-": o programa chega pela entrada padrao e o parser comeca antes do
+    // fim dela. Nao ha dump de tokens, que exigiria uma segunda passada.
+    if (fromStdin)
+    {
+        Scanner stream(std::make_unique<StreamSource>(STDIN_FILENO));
+        if (tableScanner)
+        {
+            stream.setEngine(ScannerEngine::TABLE);
+        }
+        stream.setErrorRecovery(keepGoing);
+        TokenCursor cursor(stream);
+        // A janela descarta o inicio do fonte: os erros lexicos e sintaticos
+        // recebem linha/coluna enquanto o token ainda esta nela
+        Lexer lexer{&stream};
+        return compile(cursor, engine, showTrace, errorLimit, lexer);
+    }
+
+    Scanner sc("source_code.mc");
+    if (tableScanner)
+    {
+        sc.setEngine(ScannerEngine::TABLE);
+    }
+    sc.setErrorRecovery(keepGoing);
+
+    // Scanner e parser em threads separadas, sem o dump de tokens
+    if (pipelined)
+    {
+        TokenPipeline pipeline(sc);
+        TokenCursor cursor(pipeline);
+        Lexer lexer{&sc, &pipeline};
+        return compile(cursor, engine, showTrace, errorLimit, lexer);
+    }
+
+    // Lexa o arquivo uma unica vez; o dump e o parser percorrem o mesmo buffer
+    TokenBuffer tokens = sc.tokenizeAll();
+
+    // Com --keep-going todos os erros lexicos sao listados de uma vez
+    Lexer lexer{&sc};
+    if (reportLexicalErrors(lexer))
+    {
+        return 1;
+    }
+
+    // Primeiro, imprima todos os tokens gerados pelo scanner
+    std::cout << "Token sequence:" << std::endl;
+    TokenCursor dump(tokens);
+    while (!dump.atEnd())
+    {
+        Token tk = dump.next();
+        std::cout << tk.getText() << " (Type: " << static_cast<int>(tk.getType()) << ")" << std::endl;
+    }
+
+    // Agora, proceda para a análise sintática
+    TokenCursor cursor(tokens);
+    return compile(cursor, engine, showTrace, errorLimit, lexer);
+}
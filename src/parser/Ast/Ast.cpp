@@ -0,0 +1,182 @@
+#include "Ast.h"
+#include <algorithm>
+#include <cstring>
+
+NodeId Ast::add(NodeKind kind, uint32_t offset, uint32_t left, uint32_t right, Operator op)
+{
+    NodeId id = static_cast<NodeId>(kinds.size());
+    kinds.push_back(kind);
+    ops.push_back(op);
+    offsets.push_back(offset);
+    lhs.push_back(left);
+    rhs.push_back(right);
+    return id;
+}
+
+NodeId Ast::addInteger(uint32_t offset, int64_t value)
+{
+    uint64_t bits = static_cast<uint64_t>(value);
+    return add(NodeKind::INTEGER, offset, static_cast<uint32_t>(bits), static_cast<uint32_t>(bits >> 32));
+}
+
+NodeId Ast::addReal(uint32_t offset, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    return add(NodeKind::REAL, offset, static_cast<uint32_t>(bits), static_cast<uint32_t>(bits >> 32));
+}
+
+uint32_t Ast::addExtra(std::initializer_list<uint32_t> values)
+{
+    uint32_t index = static_cast<uint32_t>(extra.size());
+    extra.insert(extra.end(), values);
+    return index;
+}
+
+uint32_t Ast::endList(size_t mark)
+{
+    uint32_t index = static_cast<uint32_t>(extra.size());
+    extra.push_back(static_cast<uint32_t>(scratch.size() - mark));
+    extra.insert(extra.end(), scratch.begin() + mark, scratch.end());
+    scratch.resize(mark);
+    return index;
+}
+
+NodeList Ast::list(uint32_t index) const
+{
+    return NodeList{extra.data() + index + 1, extra[index]};
+}
+
+void Ast::grow(size_t nodes, size_t extraCount)
+{
+    size_t size = kinds.size() + nodes;
+    kinds.resize(size);
+    ops.resize(size);
+    offsets.resize(size);
+    lhs.resize(size);
+    rhs.resize(size);
+    extra.resize(extra.size() + extraCount);
+}
+
+void Ast::place(const Ast &source, const AstRange &range, NodeId nodeAt, uint32_t extraAt)
+{
+    const uint32_t nodeShift = nodeAt - range.nodeBegin;
+    const uint32_t extraShift = extraAt - range.extraBegin;
+    auto node = [nodeShift](uint32_t id) { return id == NO_NODE ? NO_NODE : id + nodeShift; };
+
+    std::copy(source.kinds.begin() + range.nodeBegin, source.kinds.begin() + range.nodeEnd, kinds.begin() + nodeAt);
+    std::copy(source.ops.begin() + range.nodeBegin, source.ops.begin() + range.nodeEnd, ops.begin() + nodeAt);
+    std::copy(source.offsets.begin() + range.nodeBegin, source.offsets.begin() + range.nodeEnd,
+              offsets.begin() + nodeAt);
+    std::copy(source.extra.begin() + range.extraBegin, source.extra.begin() + range.extraEnd, extra.begin() + extraAt);
+
+    // Cada posicao de extra pertence a um unico no, entao corrigi-las a
+    // partir dos nos passa por todas exatamente uma vez
+    uint32_t *items = extra.data();
+    auto relocateList = [items, &node](uint32_t index) {
+        for (uint32_t i = 1; i <= items[index]; i++)
+        {
+            items[index + i] = node(items[index + i]);
+        }
+    };
+    uint32_t *leftOut = lhs.data() + nodeAt;
+    uint32_t *rightOut = rhs.data() + nodeAt;
+    for (NodeId id = range.nodeBegin; id < range.nodeEnd; id++, leftOut++, rightOut++)
+    {
+        uint32_t left = source.lhs[id];
+        uint32_t right = source.rhs[id];
+        switch (source.kinds[id])
+        {
+        case NodeKind::PROGRAM:
+            right += extraShift;
+            items[right] += extraShift;
+            items[right + 1] += extraShift;
+            items[right + 2] = node(items[right + 2]);
+            relocateList(items[right]);
+            relocateList(items[right + 1]);
+            break;
+        case NodeKind::PROCEDURE:
+            right += extraShift;
+            items[right] += extraShift;
+            items[right + 1] += extraShift;
+            items[right + 2] += extraShift;
+            items[right + 3] = node(items[right + 3]);
+            relocateList(items[right]);
+            relocateList(items[right + 1]);
+            relocateList(items[right + 2]);
+            break;
+        case NodeKind::VAR_DECL:
+        case NodeKind::COMPOUND:
+            left += extraShift;
+            relocateList(left);
+            break;
+        case NodeKind::CALL:
+            right += extraShift;
+            relocateList(right);
+            break;
+        case NodeKind::IF:
+            left = node(left);
+            right += extraShift;
+            items[right] = node(items[right]);
+            items[right + 1] = node(items[right + 1]);
+            break;
+        case NodeKind::ASSIGN:
+        case NodeKind::WHILE:
+        case NodeKind::BINARY:
+            left = node(left);
+            right = node(right);
+            break;
+        case NodeKind::UNARY:
+            left = node(left);
+            break;
+        case NodeKind::IDENTIFIER:
+        case NodeKind::INTEGER:
+        case NodeKind::REAL:
+        case NodeKind::BOOLEAN:
+            break;
+        }
+        *leftOut = left;
+        *rightOut = right;
+    }
+}
+
+int64_t Ast::integerValue(NodeId node) const
+{
+    return static_cast<int64_t>((static_cast<uint64_t>(rhs[node]) << 32) | lhs[node]);
+}
+
+double Ast::realValue(NodeId node) const
+{
+    uint64_t bits = (static_cast<uint64_t>(rhs[node]) << 32) | lhs[node];
+    double value;
+    std::memcpy(&value, &bits, sizeof value);
+    return value;
+}
+
+size_t Ast::capacityBytes() const
+{
+    return kinds.capacity() * sizeof(NodeKind) + ops.capacity() * sizeof(Operator) +
+           (offsets.capacity() + lhs.capacity() + rhs.capacity() + extra.capacity()) * sizeof(uint32_t) +
+           scratch.capacity() * sizeof(NodeId);
+}
+
+void Ast::reserve(size_t nodes)
+{
+    kinds.reserve(nodes);
+    ops.reserve(nodes);
+    offsets.reserve(nodes);
+    lhs.reserve(nodes);
+    rhs.reserve(nodes);
+}
+
+void Ast::clear()
+{
+    kinds.clear();
+    ops.clear();
+    offsets.clear();
+    lhs.clear();
+    rhs.clear();
+    extra.clear();
+    scratch.clear();
+    root = NO_NODE;
+}
@@ -0,0 +1,125 @@
+#ifndef AST_H
+#define AST_H
+
+#include <cstdint>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+// Arvore sintatica plana. Cada no e uma posicao nos vetores paralelos abaixo
+// (estrutura de arrays, como o TokenBuffer) e os filhos sao referenciados por
+// indices de 32 bits, nao por ponteiros. Tudo mora em poucos vetores
+// contiguos: montar a arvore e so acrescentar no fim, e descarta-la inteira e
+// um clear(), que ainda preserva a memoria para a proxima compilacao.
+using NodeId = uint32_t;
+constexpr NodeId NO_NODE = UINT32_MAX;
+
+// Conteudo de lhs/rhs por tipo de no. "lista" e um indice em extra, onde
+// ficam a quantidade de itens seguida dos itens.
+enum class NodeKind : uint8_t
+{
+    PROGRAM,    // lhs = SymbolId do nome, rhs = extra: [declaracoes (lista), procedimentos (lista), corpo]
+    VAR_DECL,   // lhs = lista de IDENTIFIER, rhs = Keyword do tipo
+    PROCEDURE,  // como PROGRAM, com extra: [parametros (lista de VAR_DECL), declaracoes, procedimentos, corpo]
+    COMPOUND,   // lhs = lista de comandos
+    ASSIGN,     // lhs = IDENTIFIER, rhs = expressao
+    CALL,       // lhs = SymbolId, rhs = lista de argumentos (procedimento ou funcao)
+    IF,         // lhs = condicao, rhs = extra: [then, else ou NO_NODE]
+    WHILE,      // lhs = condicao, rhs = corpo
+    BINARY,     // op = Operator, lhs e rhs = operandos
+    UNARY,      // op = Operator, lhs = operando
+    IDENTIFIER, // lhs = SymbolId
+    INTEGER,    // lhs/rhs = metades baixa/alta do int64_t
+    REAL,       // lhs/rhs = metades baixa/alta dos bits do double
+    BOOLEAN,    // lhs = 0 (false) ou 1 (true)
+};
+
+enum class Operator : uint8_t
+{
+    NONE,
+    EQUAL,
+    NOT_EQUAL,
+    LESS,
+    LESS_EQUAL,
+    GREATER,
+    GREATER_EQUAL,
+    ADD,
+    SUBTRACT,
+    OR,
+    MULTIPLY,
+    DIVIDE,
+    AND,
+    NOT,
+    NEGATE,
+    PLUS,
+};
+
+// Itens de uma lista guardada em Ast::extra
+struct NodeList
+{
+    const uint32_t *items;
+    uint32_t count;
+
+    const uint32_t *begin() const { return items; }
+    const uint32_t *end() const { return items + count; }
+};
+
+// Trecho contiguo de uma Ast: os nos [nodeBegin, nodeEnd) e as posicoes
+// [extraBegin, extraEnd) de extra que eles usam
+struct AstRange
+{
+    NodeId nodeBegin;
+    NodeId nodeEnd;
+    uint32_t extraBegin;
+    uint32_t extraEnd;
+};
+
+class Ast
+{
+public:
+    std::vector<NodeKind> kinds;
+    std::vector<Operator> ops;
+    // Offset do token que originou o no, para diagnosticos
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lhs;
+    std::vector<uint32_t> rhs;
+    // Filhos que nao cabem em lhs/rhs: listas e nos com mais de dois filhos
+    std::vector<uint32_t> extra;
+    NodeId root = NO_NODE;
+
+    NodeId add(NodeKind kind, uint32_t offset, uint32_t left = 0, uint32_t right = 0, Operator op = Operator::NONE);
+    NodeId addInteger(uint32_t offset, int64_t value);
+    NodeId addReal(uint32_t offset, double value);
+    // Guarda values em extra e devolve o indice do primeiro
+    uint32_t addExtra(std::initializer_list<uint32_t> values);
+
+    // Listas sao montadas numa pilha auxiliar, porque listas aninhadas sao
+    // construidas intercaladas: beginList marca o topo, pushItem empilha e
+    // endList copia os itens desde a marca para extra como uma lista.
+    size_t beginList() const { return scratch.size(); }
+    void pushItem(NodeId node) { scratch.push_back(node); }
+    uint32_t endList(size_t mark);
+    NodeList list(uint32_t index) const;
+
+    // Acrescenta nodes nos e extraCount posicoes de extra, a preencher com place
+    void grow(size_t nodes, size_t extraCount);
+    // Copia o trecho de source para os nos a partir de nodeAt e para extra a
+    // partir de extraAt, ja existentes, deslocando os indices; o trecho so
+    // pode referenciar a si mesmo. Fica igual a montar os mesmos nos ali.
+    // Copias para posicoes disjuntas podem rodar em paralelo.
+    void place(const Ast &source, const AstRange &range, NodeId nodeAt, uint32_t extraAt);
+
+    int64_t integerValue(NodeId node) const;
+    double realValue(NodeId node) const;
+
+    size_t size() const { return kinds.size(); }
+    // Bytes reservados por todos os vetores
+    size_t capacityBytes() const;
+    void reserve(size_t nodes);
+    void clear();
+
+private:
+    std::vector<NodeId> scratch;
+};
+
+#endif
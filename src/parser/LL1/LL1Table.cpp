@@ -0,0 +1,217 @@
+#include "LL1Table.h"
+#include <ostream>
+
+LL1Table LL1Table::build(const Grammar &grammar)
+{
+    LL1Table result;
+    LL1TableView &table = result.table;
+
+    // Terminais primeiro, na ordem dos ordinais da gramatica ("$", o marcador
+    // de fim, e o 0); "?" vem logo depois e representa tokens que nao aparecem
+    // na gramatica. Os nao-terminais seguem na mesma ordem.
+    std::vector<Symbol> ids(grammar.symbolCount(), Symbol(-1));
+    for (Grammar::Symbol terminal : grammar.terminals())
+    {
+        ids[terminal] = static_cast<Symbol>(result.nameStorage.size());
+        result.nameStorage.push_back(grammar.name(terminal));
+    }
+    Symbol unknown = static_cast<Symbol>(result.nameStorage.size());
+    result.nameStorage.push_back("?");
+    table.terminalCount = static_cast<Symbol>(result.nameStorage.size());
+    for (Grammar::Symbol nonterminal : grammar.nonterminals())
+    {
+        ids[nonterminal] = static_cast<Symbol>(result.nameStorage.size());
+        result.nameStorage.push_back(grammar.name(nonterminal));
+    }
+    table.symbolCount = static_cast<Symbol>(result.nameStorage.size());
+    result.names.assign(result.nameStorage.begin(), result.nameStorage.end());
+    table.start = grammar.startSymbol() == Grammar::INVALID ? Symbol(-1) : ids[grammar.startSymbol()];
+
+    // Mapeamento token -> terminal
+    auto lookup = [&table, &result, unknown](std::string_view name) {
+        for (Symbol terminal = 0; terminal < table.terminalCount; terminal++)
+        {
+            if (result.names[terminal] == name)
+            {
+                return terminal;
+            }
+        }
+        return unknown;
+    };
+    table.terminals = TerminalMap::fromNames(ids[grammar.endMarker()], unknown, lookup);
+    result.terminalKeywords.assign(table.terminalCount, Keyword::NONE);
+    for (size_t k = 1; k < TerminalMap::KEYWORDS; k++)
+    {
+        if (table.terminals.keywordTerminals[k] != unknown)
+        {
+            result.terminalKeywords[table.terminals.keywordTerminals[k]] = static_cast<Keyword>(k);
+        }
+    }
+
+    // Producoes num vetor plano, na ordem da gramatica
+    result.rhsStart.push_back(0);
+    for (uint32_t production = 0; production < grammar.productionCount(); production++)
+    {
+        result.productionLhs.push_back(ids[grammar.lhs(production)]);
+        for (const Grammar::Symbol *symbol = grammar.bodyBegin(production); symbol != grammar.bodyEnd(production);
+             symbol++)
+        {
+            result.rhs.push_back(ids[*symbol]);
+        }
+        result.rhsStart.push_back(static_cast<uint32_t>(result.rhs.size()));
+    }
+
+    size_t nonterminalCount = grammar.nonterminals().size();
+    result.cells.assign(nonterminalCount * table.terminalCount, NO_PRODUCTION);
+    result.follow.assign(nonterminalCount * table.terminalCount, 0);
+
+    // Daqui em diante os vetores nao mudam de tamanho
+    table.names = result.names.data();
+    table.terminalKeywords = result.terminalKeywords.data();
+    table.productionLhs = result.productionLhs.data();
+    table.rhs = result.rhs.data();
+    table.rhsStart = result.rhsStart.data();
+    table.cells = result.cells.data();
+    table.follow = result.follow.data();
+
+    // Os ordinais dos terminais da gramatica coincidem com os simbolos da tabela
+    Grammar::Analysis analysis = grammar.analyze();
+    size_t grammarTerminals = grammar.terminals().size();
+    for (size_t row = 0; row < nonterminalCount; row++)
+    {
+        for (size_t terminal = 0; terminal < grammarTerminals; terminal++)
+        {
+            if (analysis.follow.contains(row, terminal))
+            {
+                result.follow[row * table.terminalCount + terminal] = 1;
+            }
+        }
+    }
+
+    auto place = [&table, &result](Symbol nonterminal, Symbol terminal, int16_t production) {
+        int16_t &cell = result.cells[table.cellIndex(nonterminal, terminal)];
+        if (cell == NO_PRODUCTION)
+        {
+            cell = production;
+        }
+        else if (cell != production)
+        {
+            result.conflicts.push_back({result.nameStorage[nonterminal], result.nameStorage[terminal],
+                                        table.productionText(cell), table.productionText(production)});
+        }
+    };
+
+    // Duas passadas: as entradas vindas de FIRST entram antes das vindas de
+    // FOLLOW, entao uma producao ε nunca toma o lugar de uma que consome o token
+    size_t words = analysis.first.wordsPerRow();
+    std::vector<uint64_t> productionFirst(grammar.productionCount() * words, 0);
+    std::vector<uint8_t> productionNullable(grammar.productionCount(), 0);
+    for (uint32_t production = 0; production < grammar.productionCount(); production++)
+    {
+        uint64_t *first = productionFirst.data() + production * words;
+        productionNullable[production] =
+            grammar.firstOfSequence(analysis, grammar.bodyBegin(production), grammar.bodyEnd(production), first);
+        for (size_t terminal = 0; terminal < grammarTerminals; terminal++)
+        {
+            if ((first[terminal / 64] >> (terminal % 64)) & 1)
+            {
+                place(result.productionLhs[production], static_cast<Symbol>(terminal), static_cast<int16_t>(production));
+            }
+        }
+    }
+    for (uint32_t production = 0; production < grammar.productionCount(); production++)
+    {
+        if (!productionNullable[production])
+        {
+            continue;
+        }
+        uint32_t row = grammar.ordinal(grammar.lhs(production));
+        for (size_t terminal = 0; terminal < grammarTerminals; terminal++)
+        {
+            if (analysis.follow.contains(row, terminal))
+            {
+                place(result.productionLhs[production], static_cast<Symbol>(terminal), static_cast<int16_t>(production));
+            }
+        }
+    }
+
+    return result;
+}
+
+LL1Table LL1Table::fromLanguageGrammar()
+{
+    Grammar grammar = Grammar::fromRules(getGramatica(), "programa");
+    grammar.prepareForLL1();
+    return build(grammar);
+}
+
+std::string LL1TableView::productionText(int16_t production) const
+{
+    std::string text = std::string(names[productionLhs[production]]) + " ->";
+    if (rhsBegin(production) == rhsEnd(production))
+    {
+        return text + " ε";
+    }
+    for (const Symbol *symbol = rhsBegin(production); symbol != rhsEnd(production); symbol++)
+    {
+        text += " ";
+        text += names[*symbol];
+    }
+    return text;
+}
+
+bool LL1TableView::sameEntries(const LL1TableView &other) const
+{
+    if (terminalCount != other.terminalCount || symbolCount != other.symbolCount)
+    {
+        return false;
+    }
+
+    // Simbolo correspondente na outra tabela, pelo nome
+    std::vector<Symbol> mapped(symbolCount, Symbol(-1));
+    for (Symbol symbol = 0; symbol < symbolCount; symbol++)
+    {
+        for (Symbol candidate = 0; candidate < other.symbolCount; candidate++)
+        {
+            if (names[symbol] == other.names[candidate])
+            {
+                mapped[symbol] = candidate;
+            }
+        }
+        if (mapped[symbol] < 0 || isTerminal(symbol) != other.isTerminal(mapped[symbol]))
+        {
+            return false;
+        }
+    }
+
+    for (Symbol nonterminal = terminalCount; nonterminal < symbolCount; nonterminal++)
+    {
+        for (Symbol terminal = 0; terminal < terminalCount; terminal++)
+        {
+            int16_t mine = production(nonterminal, terminal);
+            int16_t theirs = other.production(mapped[nonterminal], mapped[terminal]);
+            if (inFollow(nonterminal, terminal) != other.inFollow(mapped[nonterminal], mapped[terminal]) ||
+                (mine == NO_PRODUCTION) != (theirs == NO_PRODUCTION))
+            {
+                return false;
+            }
+            if (mine != NO_PRODUCTION && productionText(mine) != other.productionText(theirs))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void LL1Table::report(std::ostream &out) const
+{
+    out << "LL(1): " << table.terminalCount << " terminals, " << table.symbolCount - table.terminalCount
+        << " nonterminals, " << productionLhs.size() << " productions, " << conflicts.size() << " conflicts"
+        << std::endl;
+    for (const LL1Conflict &conflict : conflicts)
+    {
+        out << "conflict at [" << conflict.nonterminal << ", " << conflict.terminal << "]: kept '" << conflict.kept
+            << "' over '" << conflict.discarded << "'" << std::endl;
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef LL1_TABLE_H
+#define LL1_TABLE_H
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../lexical/Token/Token.h"
+#include "../TerminalMap.h"
+#include "../utils/Grammar.h"
+
+// Celula da tabela disputada por duas producoes. A tabela fica com kept; a
+// preferencia e pela producao que comeca com o terminal (resolve o else
+// pendente a favor do if mais interno) e, entre iguais, pela primeira.
+struct LL1Conflict
+{
+    std::string nonterminal;
+    std::string terminal;
+    std::string kept;
+    std::string discarded;
+};
+
+// O que o PredictiveParser consulta, so leitura. Os simbolos sao inteiros,
+// terminais em [0, terminalCount) e nao-terminais em seguida; as producoes
+// ficam num vetor plano e cada celula guarda o indice da producao ou
+// NO_PRODUCTION. Os ponteiros apontam para os vetores de uma LL1Table ou para
+// os arrays constexpr de StaticLL1Table.h.
+struct LL1TableView
+{
+    using Symbol = int16_t;
+    static constexpr int16_t NO_PRODUCTION = -1;
+
+    Symbol terminalCount = 0;
+    Symbol symbolCount = 0;
+    Symbol start = 0;
+    TerminalMap terminals;
+
+    const std::string_view *names = nullptr;
+    const Keyword *terminalKeywords = nullptr;
+    const Symbol *productionLhs = nullptr;
+    const Symbol *rhs = nullptr;
+    const uint32_t *rhsStart = nullptr;
+    const int16_t *cells = nullptr;
+    const uint8_t *follow = nullptr;
+
+    // Terminal da gramatica que corresponde ao token; unknownTerminal() se nenhum
+    Symbol terminalOf(const Token &token) const { return terminals.terminalOf(token); }
+
+    bool isTerminal(Symbol symbol) const { return symbol < terminalCount; }
+    Symbol startSymbol() const { return start; }
+    Symbol endMarker() const { return terminals.end; }
+    Symbol unknownTerminal() const { return terminals.unknown; }
+
+    int16_t production(Symbol nonterminal, Symbol terminal) const
+    {
+        return cells[cellIndex(nonterminal, terminal)];
+    }
+    bool inFollow(Symbol nonterminal, Symbol terminal) const
+    {
+        return follow[cellIndex(nonterminal, terminal)] != 0;
+    }
+    // Lado direito da producao, na ordem da regra
+    const Symbol *rhsBegin(int16_t production) const { return rhs + rhsStart[production]; }
+    const Symbol *rhsEnd(int16_t production) const { return rhs + rhsStart[production + 1]; }
+
+    std::string_view name(Symbol symbol) const { return names[symbol]; }
+    // Palavra-chave ou pontuacao do terminal, para as mensagens de erro
+    Keyword keywordOf(Symbol terminal) const { return terminalKeywords[terminal]; }
+
+    // "A -> x y", "A -> ε"
+    std::string productionText(int16_t production) const;
+    // true se as duas tabelas escolhem as mesmas producoes nas mesmas
+    // celulas, comparando pelos nomes (a numeracao pode diferir)
+    bool sameEntries(const LL1TableView &other) const;
+
+    constexpr size_t cellIndex(Symbol nonterminal, Symbol terminal) const
+    {
+        return static_cast<size_t>(nonterminal - terminalCount) * terminalCount + terminal;
+    }
+};
+
+// Tabela LL(1) gerada em tempo de execucao de uma Grammar ja transformada
+// (prepareForLL1), dona dos dados para onde a view aponta. Serve para
+// experimentar com a gramatica; a linguagem usa a tabela constexpr.
+class LL1Table
+{
+public:
+    using Symbol = LL1TableView::Symbol;
+    static constexpr int16_t NO_PRODUCTION = LL1TableView::NO_PRODUCTION;
+
+    static LL1Table build(const Grammar &grammar);
+    // Tabela da linguagem: getGramatica() passada por prepareForLL1
+    static LL1Table fromLanguageGrammar();
+
+    // A view aponta para os vetores: mover preserva os buffers, copiar nao
+    LL1Table() = default;
+    LL1Table(const LL1Table &) = delete;
+    LL1Table &operator=(const LL1Table &) = delete;
+    LL1Table(LL1Table &&) = default;
+    LL1Table &operator=(LL1Table &&) = default;
+
+    const LL1TableView &view() const { return table; }
+    const std::vector<LL1Conflict> &getConflicts() const { return conflicts; }
+    void report(std::ostream &out) const;
+
+private:
+    LL1TableView table;
+    std::vector<std::string> nameStorage;
+    std::vector<std::string_view> names;
+    std::vector<Keyword> terminalKeywords;
+    std::vector<Symbol> productionLhs;
+    std::vector<Symbol> rhs;
+    std::vector<uint32_t> rhsStart;
+    std::vector<int16_t> cells;
+    std::vector<uint8_t> follow;
+    std::vector<LL1Conflict> conflicts;
+};
+
+#endif
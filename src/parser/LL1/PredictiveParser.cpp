@@ -0,0 +1,115 @@
+#include "PredictiveParser.h"
+#include <stdexcept>
+
+PredictiveParser::PredictiveParser(TokenCursor &tokens, const LL1TableView &table) : tokens(tokens), table(table) {}
+
+void PredictiveParser::advance()
+{
+    currentToken = tokens.next();
+    lookahead = table.terminalOf(currentToken);
+}
+
+bool PredictiveParser::parse()
+{
+    stack.clear();
+    stack.push_back(table.endMarker());
+    stack.push_back(table.startSymbol());
+    advance();
+
+    while (!stack.empty())
+    {
+        Symbol top = stack.back();
+        if (table.isTerminal(top))
+        {
+            if (top == lookahead)
+            {
+                stack.pop_back();
+                if (top == table.endMarker())
+                {
+                    break;
+                }
+                panicking = false;
+                advance();
+                continue;
+            }
+
+            // Terminal ausente: reporta e segue como se ele estivesse la. No
+            // fim da pilha sobra entrada e nao ha mais o que fazer.
+            if (!reportMissing(top) || top == table.endMarker())
+            {
+                break;
+            }
+            stack.pop_back();
+            continue;
+        }
+
+        int16_t production = table.production(top, lookahead);
+        if (production != LL1TableView::NO_PRODUCTION)
+        {
+            stack.pop_back();
+            for (const Symbol *symbol = table.rhsEnd(production); symbol != table.rhsBegin(production);)
+            {
+                stack.push_back(*--symbol);
+            }
+            continue;
+        }
+
+        // Modo panico: descarta tokens ate um que o topo aceite ou que possa
+        // vir depois dele; no segundo caso o topo e abandonado
+        if (!report(SyntaxErrorCode::UNEXPECTED_TOKEN))
+        {
+            break;
+        }
+        while (lookahead != table.endMarker() && table.production(top, lookahead) == LL1TableView::NO_PRODUCTION &&
+               !table.inFollow(top, lookahead))
+        {
+            advance();
+        }
+        if (table.production(top, lookahead) == LL1TableView::NO_PRODUCTION)
+        {
+            stack.pop_back();
+        }
+    }
+
+    return diagnostics.empty();
+}
+
+__attribute__((cold)) bool PredictiveParser::reportMissing(Symbol terminal)
+{
+    Keyword keyword = table.keywordOf(terminal);
+    if (keyword != Keyword::NONE)
+    {
+        return report(SyntaxErrorCode::EXPECTED_KEYWORD, keyword);
+    }
+    if (table.name(terminal) == "id")
+    {
+        return report(SyntaxErrorCode::UNEXPECTED_TOKEN_TYPE, Keyword::NONE, TokenType::IDENTIFIER);
+    }
+    return report(SyntaxErrorCode::UNEXPECTED_TOKEN);
+}
+
+__attribute__((cold)) bool PredictiveParser::report(SyntaxErrorCode code, Keyword expectedKeyword, TokenType expectedType)
+{
+    if (panicking)
+    {
+        return true;
+    }
+    panicking = true;
+    diagnostics.push_back({currentToken.getOffset(), static_cast<uint32_t>(currentToken.getText().size()), code,
+                           expectedKeyword, expectedType, tokens.locate(currentToken.getOffset())});
+    return diagnostics.size() < errorLimit;
+}
+
+const std::vector<SyntaxDiagnostic> &PredictiveParser::getDiagnostics() const
+{
+    return diagnostics;
+}
+
+void PredictiveParser::setErrorLimit(size_t limit)
+{
+    if (limit == 0)
+    {
+        throw std::out_of_range("error limit must be at least 1");
+    }
+    errorLimit = limit;
+}
@@ -0,0 +1,42 @@
+#ifndef PREDICTIVE_PARSER_H
+#define PREDICTIVE_PARSER_H
+
+#include <vector>
+
+#include "../../lexical/TokenBuffer/TokenBuffer.h"
+#include "../SyntaxDiagnostic.h"
+#include "LL1Table.h"
+
+// Analisador preditivo dirigido por uma tabela LL(1), sem recursao: a forma
+// sentencial pendente fica numa pilha explicita. So reconhece o programa;
+// nao monta a arvore. Os erros seguem o modelo do Parser (modo panico com
+// limite de diagnosticos), sincronizando pelo FOLLOW do nao-terminal do topo.
+class PredictiveParser
+{
+public:
+    PredictiveParser(TokenCursor &tokens, const LL1TableView &table);
+    // true se o programa foi aceito sem erros
+    bool parse();
+    const std::vector<SyntaxDiagnostic> &getDiagnostics() const;
+    // Como Parser::setErrorLimit
+    void setErrorLimit(size_t limit);
+
+private:
+    using Symbol = LL1TableView::Symbol;
+
+    TokenCursor &tokens;
+    const LL1TableView &table;
+    Token currentToken;
+    Symbol lookahead = 0;
+    std::vector<Symbol> stack;
+    std::vector<SyntaxDiagnostic> diagnostics;
+    size_t errorLimit = 25;
+    bool panicking = false;
+
+    void advance();
+    // Guarda o erro; false quando o limite foi atingido e a analise deve parar
+    bool report(SyntaxErrorCode code, Keyword expectedKeyword = Keyword::NONE, TokenType expectedType = TokenType::NONE);
+    bool reportMissing(Symbol terminal);
+};
+
+#endif
@@ -0,0 +1,501 @@
+#ifndef STATIC_LL1_TABLE_H
+#define STATIC_LL1_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "LL1Table.h"
+
+// Tabela LL(1) montada pelo compilador a partir de uma gramatica em texto no
+// formato de GRAMATICA_LL1. Tudo aqui e constexpr: a leitura do texto,
+// anulaveis, FIRST, FOLLOW e as celulas. Os arrays resultantes ficam em
+// dados somente leitura e a view aponta direto para eles, sem custo na
+// inicializacao do programa.
+
+// Gramatica lida do texto, com capacidade fixa; so existe durante a compilacao
+struct StaticGrammarText
+{
+    static constexpr size_t MAX_SYMBOLS = 128;
+    static constexpr size_t MAX_PRODUCTIONS = 192;
+    static constexpr size_t MAX_RHS = 768;
+
+    std::array<std::string_view, MAX_SYMBOLS> names{};
+    std::array<bool, MAX_SYMBOLS> nonterminal{};
+    size_t symbolCount = 0;
+    size_t nonterminalCount = 0;
+    std::array<uint16_t, MAX_PRODUCTIONS> lhs{};
+    std::array<uint32_t, MAX_PRODUCTIONS + 1> rhsStart{};
+    std::array<uint16_t, MAX_RHS> rhs{};
+    size_t productionCount = 0;
+    size_t rhsCount = 0;
+    // false se alguma linha nao tem "->" ou a capacidade acabou
+    bool wellFormed = true;
+
+    constexpr size_t terminalCount() const { return symbolCount - nonterminalCount; }
+
+    constexpr uint16_t find(std::string_view name) const
+    {
+        for (size_t i = 0; i < symbolCount; i++)
+        {
+            if (names[i] == name)
+            {
+                return static_cast<uint16_t>(i);
+            }
+        }
+        return UINT16_MAX;
+    }
+
+    constexpr uint16_t intern(std::string_view name, bool isNonterminal)
+    {
+        uint16_t found = find(name);
+        if (found != UINT16_MAX)
+        {
+            return found;
+        }
+        if (symbolCount == MAX_SYMBOLS)
+        {
+            wellFormed = false;
+            return 0;
+        }
+        names[symbolCount] = name;
+        nonterminal[symbolCount] = isNonterminal;
+        nonterminalCount += isNonterminal ? 1 : 0;
+        return static_cast<uint16_t>(symbolCount++);
+    }
+
+    static constexpr std::string_view nextLine(std::string_view text, size_t &position)
+    {
+        size_t begin = position;
+        while (position < text.size() && text[position] != '\n')
+        {
+            position++;
+        }
+        std::string_view line = text.substr(begin, position - begin);
+        if (position < text.size())
+        {
+            position++;
+        }
+        return line;
+    }
+
+    static constexpr std::string_view nextWord(std::string_view line, size_t &position)
+    {
+        while (position < line.size() && line[position] == ' ')
+        {
+            position++;
+        }
+        size_t begin = position;
+        while (position < line.size() && line[position] != ' ')
+        {
+            position++;
+        }
+        return line.substr(begin, position - begin);
+    }
+
+    static constexpr StaticGrammarText parse(std::string_view text)
+    {
+        StaticGrammarText grammar;
+
+        // Primeira passada: as cabecas, para saber quem e nao-terminal
+        for (size_t position = 0; position < text.size();)
+        {
+            std::string_view line = nextLine(text, position);
+            size_t column = 0;
+            std::string_view head = nextWord(line, column);
+            if (!head.empty())
+            {
+                grammar.intern(head, true);
+            }
+        }
+
+        // Segunda passada: as producoes, na ordem do texto
+        for (size_t position = 0; position < text.size();)
+        {
+            std::string_view line = nextLine(text, position);
+            size_t column = 0;
+            std::string_view head = nextWord(line, column);
+            if (head.empty())
+            {
+                continue;
+            }
+            if (nextWord(line, column) != "->")
+            {
+                grammar.wellFormed = false;
+                break;
+            }
+
+            uint16_t lhs = grammar.find(head);
+            bool open = false;
+            for (std::string_view word = nextWord(line, column);; word = nextWord(line, column))
+            {
+                if (!open)
+                {
+                    if (grammar.productionCount == MAX_PRODUCTIONS)
+                    {
+                        grammar.wellFormed = false;
+                        return grammar;
+                    }
+                    grammar.lhs[grammar.productionCount] = lhs;
+                    grammar.rhsStart[grammar.productionCount] = static_cast<uint32_t>(grammar.rhsCount);
+                    open = true;
+                }
+                if (word.empty() || word == "|")
+                {
+                    grammar.productionCount++;
+                    grammar.rhsStart[grammar.productionCount] = static_cast<uint32_t>(grammar.rhsCount);
+                    open = false;
+                    if (word.empty())
+                    {
+                        break;
+                    }
+                    continue;
+                }
+                if (word == "ε")
+                {
+                    continue;
+                }
+                if (grammar.rhsCount == MAX_RHS)
+                {
+                    grammar.wellFormed = false;
+                    return grammar;
+                }
+                grammar.rhs[grammar.rhsCount++] = grammar.intern(word, false);
+            }
+        }
+        return grammar;
+    }
+};
+
+// Tamanhos dos arrays da tabela: os terminais da gramatica mais "$" e "?"
+struct StaticLL1Shape
+{
+    size_t terminals;
+    size_t nonterminals;
+    size_t productions;
+    size_t rhsSymbols;
+};
+
+constexpr StaticLL1Shape measureStaticLL1(std::string_view text)
+{
+    StaticGrammarText grammar = StaticGrammarText::parse(text);
+    return {grammar.terminalCount() + 2, grammar.nonterminalCount, grammar.productionCount, grammar.rhsCount};
+}
+
+// Mesma numeracao da LL1Table: "$" e 0, os terminais na ordem em que aparecem,
+// "?" por ultimo entre os terminais, depois os nao-terminais na ordem das
+// cabecas. Mesmo desempate tambem: a producao que consome o terminal fica
+// com a celula e a que viria do FOLLOW e descartada; esses conflitos sao
+// contados em resolvedConflicts. Os demais vao para unresolvedConflicts.
+template <size_t T, size_t N, size_t P, size_t R>
+struct StaticLL1Table
+{
+    using Symbol = LL1TableView::Symbol;
+
+    std::array<std::string_view, T + N> names{};
+    std::array<Keyword, T> terminalKeywords{};
+    std::array<Symbol, P> productionLhs{};
+    std::array<Symbol, (R > 0 ? R : 1)> rhs{};
+    std::array<uint32_t, P + 1> rhsStart{};
+    std::array<int16_t, N * T> cells{};
+    std::array<uint8_t, N * T> follow{};
+    LL1TableView table{};
+    bool wellFormed = false;
+    size_t resolvedConflicts = 0;
+    size_t unresolvedConflicts = 0;
+
+    constexpr Symbol symbolNamed(std::string_view name) const
+    {
+        for (size_t i = 0; i < T + N; i++)
+        {
+            if (names[i] == name)
+            {
+                return static_cast<Symbol>(i);
+            }
+        }
+        return -1;
+    }
+
+    // Producao escolhida em [nonterminal, terminal], pelos nomes; para os
+    // static_assert sobre a tabela
+    constexpr int16_t entry(std::string_view nonterminal, std::string_view terminal) const
+    {
+        Symbol row = symbolNamed(nonterminal);
+        Symbol column = symbolNamed(terminal);
+        if (row < static_cast<Symbol>(T) || column < 0 || column >= static_cast<Symbol>(T))
+        {
+            return LL1TableView::NO_PRODUCTION;
+        }
+        return cells[static_cast<size_t>(row - T) * T + column];
+    }
+
+    // true se a producao nao e ε
+    constexpr bool consumes(int16_t production) const
+    {
+        return rhsStart[production] != rhsStart[production + 1];
+    }
+
+    // A view aponta para os arrays deste objeto, que deve ter duracao
+    // estatica (uma variavel constexpr)
+    constexpr LL1TableView view() const
+    {
+        LL1TableView result = table;
+        result.names = names.data();
+        result.terminalKeywords = terminalKeywords.data();
+        result.productionLhs = productionLhs.data();
+        result.rhs = rhs.data();
+        result.rhsStart = rhsStart.data();
+        result.cells = cells.data();
+        result.follow = follow.data();
+        return result;
+    }
+
+    static constexpr StaticLL1Table build(std::string_view text)
+    {
+        StaticLL1Table result;
+        StaticGrammarText grammar = StaticGrammarText::parse(text);
+        result.wellFormed = grammar.wellFormed && grammar.terminalCount() + 2 == T &&
+                            grammar.nonterminalCount == N && grammar.productionCount == P && grammar.rhsCount == R;
+        if (!result.wellFormed)
+        {
+            return result;
+        }
+
+        // Numeracao final
+        std::array<Symbol, StaticGrammarText::MAX_SYMBOLS> ids{};
+        Symbol next = 0;
+        result.names[next++] = "$";
+        for (size_t i = 0; i < grammar.symbolCount; i++)
+        {
+            if (!grammar.nonterminal[i])
+            {
+                ids[i] = next;
+                result.names[next++] = grammar.names[i];
+            }
+        }
+        result.names[next++] = "?";
+        for (size_t i = 0; i < grammar.symbolCount; i++)
+        {
+            if (grammar.nonterminal[i])
+            {
+                ids[i] = next;
+                result.names[next++] = grammar.names[i];
+            }
+        }
+
+        LL1TableView &table = result.table;
+        table.terminalCount = static_cast<Symbol>(T);
+        table.symbolCount = static_cast<Symbol>(T + N);
+        table.start = static_cast<Symbol>(T);
+
+        for (size_t p = 0; p < P; p++)
+        {
+            result.productionLhs[p] = ids[grammar.lhs[p]];
+            result.rhsStart[p] = grammar.rhsStart[p];
+            for (size_t i = grammar.rhsStart[p]; i < grammar.rhsStart[p + 1]; i++)
+            {
+                result.rhs[i] = ids[grammar.rhs[i]];
+            }
+        }
+        result.rhsStart[P] = static_cast<uint32_t>(R);
+
+        // Mapeamento token -> terminal
+        auto lookup = [&result](std::string_view name) {
+            for (size_t terminal = 0; terminal + 1 < T; terminal++)
+            {
+                if (result.names[terminal] == name)
+                {
+                    return static_cast<Symbol>(terminal);
+                }
+            }
+            return static_cast<Symbol>(T - 1);
+        };
+        table.terminals = TerminalMap::fromNames(0, static_cast<Symbol>(T - 1), lookup);
+        for (size_t k = 1; k < TerminalMap::KEYWORDS; k++)
+        {
+            Symbol terminal = table.terminals.keywordTerminals[k];
+            if (terminal != table.terminals.unknown)
+            {
+                result.terminalKeywords[terminal] = static_cast<Keyword>(k);
+            }
+        }
+
+        // Anulaveis e FIRST por ponto fixo; linhas por nao-terminal
+        auto row = [](Symbol nonterminal) { return static_cast<size_t>(nonterminal) - T; };
+        std::array<bool, N> nullable{};
+        std::array<bool, N * T> first{};
+        for (bool changed = true; changed;)
+        {
+            changed = false;
+            for (size_t p = 0; p < P; p++)
+            {
+                size_t a = row(result.productionLhs[p]);
+                bool allNullable = true;
+                for (size_t i = result.rhsStart[p]; i < result.rhsStart[p + 1] && allNullable; i++)
+                {
+                    Symbol symbol = result.rhs[i];
+                    if (symbol < static_cast<Symbol>(T))
+                    {
+                        changed = changed || !first[a * T + symbol];
+                        first[a * T + symbol] = true;
+                        allNullable = false;
+                        continue;
+                    }
+                    size_t b = row(symbol);
+                    for (size_t t = 0; t < T; t++)
+                    {
+                        if (first[b * T + t] && !first[a * T + t])
+                        {
+                            first[a * T + t] = true;
+                            changed = true;
+                        }
+                    }
+                    allNullable = nullable[b];
+                }
+                if (allNullable && !nullable[a])
+                {
+                    nullable[a] = true;
+                    changed = true;
+                }
+            }
+        }
+
+        // FIRST de rhs[begin, end) em out; true se anulavel
+        auto firstOf = [&](size_t begin, size_t end, std::array<bool, T> &out) {
+            for (size_t i = begin; i < end; i++)
+            {
+                Symbol symbol = result.rhs[i];
+                if (symbol < static_cast<Symbol>(T))
+                {
+                    out[symbol] = true;
+                    return false;
+                }
+                size_t b = row(symbol);
+                for (size_t t = 0; t < T; t++)
+                {
+                    out[t] = out[t] || first[b * T + t];
+                }
+                if (!nullable[b])
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        // FOLLOW por ponto fixo
+        result.follow[row(table.start) * T + table.terminals.end] = 1;
+        for (bool changed = true; changed;)
+        {
+            changed = false;
+            for (size_t p = 0; p < P; p++)
+            {
+                size_t a = row(result.productionLhs[p]);
+                for (size_t i = result.rhsStart[p]; i < result.rhsStart[p + 1]; i++)
+                {
+                    if (result.rhs[i] < static_cast<Symbol>(T))
+                    {
+                        continue;
+                    }
+                    size_t b = row(result.rhs[i]);
+                    std::array<bool, T> rest{};
+                    bool restNullable = firstOf(i + 1, result.rhsStart[p + 1], rest);
+                    for (size_t t = 0; t < T; t++)
+                    {
+                        bool add = rest[t] || (restNullable && result.follow[a * T + t]);
+                        if (add && !result.follow[b * T + t])
+                        {
+                            result.follow[b * T + t] = 1;
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Celulas: FIRST antes de FOLLOW, como na LL1Table
+        for (size_t i = 0; i < N * T; i++)
+        {
+            result.cells[i] = LL1TableView::NO_PRODUCTION;
+        }
+        std::array<bool, N * T> fromFollow{};
+        for (size_t p = 0; p < P; p++)
+        {
+            size_t a = row(result.productionLhs[p]);
+            std::array<bool, T> productionFirst{};
+            firstOf(result.rhsStart[p], result.rhsStart[p + 1], productionFirst);
+            for (size_t t = 0; t < T; t++)
+            {
+                if (!productionFirst[t])
+                {
+                    continue;
+                }
+                int16_t &cell = result.cells[a * T + t];
+                if (cell == LL1TableView::NO_PRODUCTION)
+                {
+                    cell = static_cast<int16_t>(p);
+                }
+                else
+                {
+                    result.unresolvedConflicts++;
+                }
+            }
+        }
+        for (size_t p = 0; p < P; p++)
+        {
+            size_t a = row(result.productionLhs[p]);
+            std::array<bool, T> productionFirst{};
+            if (!firstOf(result.rhsStart[p], result.rhsStart[p + 1], productionFirst))
+            {
+                continue;
+            }
+            for (size_t t = 0; t < T; t++)
+            {
+                if (!result.follow[a * T + t])
+                {
+                    continue;
+                }
+                int16_t &cell = result.cells[a * T + t];
+                if (cell == LL1TableView::NO_PRODUCTION)
+                {
+                    cell = static_cast<int16_t>(p);
+                    fromFollow[a * T + t] = true;
+                }
+                else if (cell != static_cast<int16_t>(p))
+                {
+                    if (fromFollow[a * T + t])
+                    {
+                        result.unresolvedConflicts++;
+                    }
+                    else
+                    {
+                        result.resolvedConflicts++;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+};
+
+// A tabela da linguagem, de GRAMATICA_LL1
+inline constexpr StaticLL1Shape LANGUAGE_LL1_SHAPE = measureStaticLL1(GRAMATICA_LL1);
+inline constexpr auto LANGUAGE_LL1 =
+    StaticLL1Table<LANGUAGE_LL1_SHAPE.terminals, LANGUAGE_LL1_SHAPE.nonterminals, LANGUAGE_LL1_SHAPE.productions,
+                   LANGUAGE_LL1_SHAPE.rhsSymbols>::build(GRAMATICA_LL1);
+inline constexpr LL1TableView LANGUAGE_LL1_TABLE = LANGUAGE_LL1.view();
+
+static_assert(LANGUAGE_LL1.wellFormed, "GRAMATICA_LL1 mal formada");
+static_assert(LANGUAGE_LL1.unresolvedConflicts == 0, "GRAMATICA_LL1 nao e LL(1)");
+// O unico desempate aceito e o do else pendente, a favor do if mais interno
+static_assert(LANGUAGE_LL1.resolvedConflicts == 1, "conflito LL(1) novo em GRAMATICA_LL1");
+static_assert(LANGUAGE_LL1.entry("parte_else", "else") != LL1TableView::NO_PRODUCTION &&
+                  LANGUAGE_LL1.consumes(LANGUAGE_LL1.entry("parte_else", "else")),
+              "o else deve ficar com o if mais interno");
+static_assert(LANGUAGE_LL1_TABLE.terminals.identifier != LANGUAGE_LL1_TABLE.terminals.unknown &&
+                  LANGUAGE_LL1_TABLE.terminals.keywordTerminals[static_cast<size_t>(Keyword::BEGIN)] !=
+                      LANGUAGE_LL1_TABLE.terminals.unknown,
+              "tokens da linguagem sem terminal na GRAMATICA_LL1");
+
+#endif
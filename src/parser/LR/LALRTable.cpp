@@ -0,0 +1,580 @@
+#include "LALRTable.h"
+#include <algorithm>
+#include <numeric>
+#include <ostream>
+#include <unordered_map>
+
+namespace
+{
+    // Item completo: nao ha simbolo depois do ponto
+    constexpr uint32_t NO_NEXT = UINT32_MAX;
+
+    struct KernelHash
+    {
+        size_t operator()(const std::vector<uint32_t> &kernel) const
+        {
+            size_t hash = kernel.size();
+            for (uint32_t item : kernel)
+            {
+                hash = hash * 1000003u ^ item;
+            }
+            return hash;
+        }
+    };
+
+    using SparseRow = std::vector<std::pair<int32_t, int16_t>>;
+
+    // Linhas esparsas encaixadas num vetor so: cada linha recebe a menor base
+    // em que todas as suas colunas caem em posicoes livres, comecando pelas
+    // linhas mais cheias. check guarda a linha dona da posicao (-1 se livre) e
+    // o vetor cobre base + width, entao qualquer coluna pode ser consultada.
+    void displaceRows(const std::vector<SparseRow> &rows, size_t width, std::vector<int32_t> &base,
+                      std::vector<int16_t> &value, std::vector<int16_t> &check)
+    {
+        std::vector<size_t> order(rows.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&rows](size_t a, size_t b) { return rows[a].size() > rows[b].size(); });
+
+        base.assign(rows.size(), 0);
+        check.assign(width, -1);
+        value.assign(width, 0);
+        size_t firstFree = 0;
+        for (size_t row : order)
+        {
+            const SparseRow &entries = rows[row];
+            if (entries.empty())
+            {
+                continue;
+            }
+
+            int32_t candidate = std::max<int32_t>(0, static_cast<int32_t>(firstFree) - entries.front().first);
+            for (;; candidate++)
+            {
+                bool fits = true;
+                for (const auto &[column, action] : entries)
+                {
+                    size_t slot = static_cast<size_t>(candidate + column);
+                    if (slot < check.size() && check[slot] != -1)
+                    {
+                        fits = false;
+                        break;
+                    }
+                }
+                if (fits)
+                {
+                    break;
+                }
+            }
+
+            if (check.size() < candidate + width)
+            {
+                check.resize(candidate + width, -1);
+                value.resize(candidate + width, 0);
+            }
+            for (const auto &[column, action] : entries)
+            {
+                check[candidate + column] = static_cast<int16_t>(row);
+                value[candidate + column] = action;
+            }
+            base[row] = candidate;
+            while (firstFree < check.size() && check[firstFree] != -1)
+            {
+                firstFree++;
+            }
+        }
+    }
+
+    // Valor mais frequente da linha entre os aceitos por eligible; fallback se nenhum
+    template <typename Eligible>
+    int16_t mostFrequent(const SparseRow &row, int16_t fallback, Eligible eligible)
+    {
+        int16_t best = fallback;
+        size_t bestCount = 0;
+        for (const auto &[column, action] : row)
+        {
+            if (!eligible(action))
+            {
+                continue;
+            }
+            size_t count = 0;
+            for (const auto &[other, value] : row)
+            {
+                count += value == action ? 1 : 0;
+            }
+            if (count > bestCount || (count == bestCount && action > best))
+            {
+                best = action;
+                bestCount = count;
+            }
+        }
+        return best;
+    }
+}
+
+LALRTable LALRTable::build(const Grammar &grammar)
+{
+    LALRTable table;
+    const uint32_t terminalCount = static_cast<uint32_t>(grammar.terminals().size());
+    const uint32_t nonterminalCount = static_cast<uint32_t>(grammar.nonterminals().size());
+    const uint32_t productions = static_cast<uint32_t>(grammar.productionCount());
+    const uint32_t augmented = productions;
+    table.nonterminalCount = nonterminalCount;
+
+    // Simbolos locais: terminais pelo ordinal, nao-terminais em terminalCount
+    // + ordinal. A producao aumentada S' -> inicial vem depois das outras.
+    auto local = [&grammar, terminalCount](Grammar::Symbol symbol) {
+        return grammar.isNonterminal(symbol) ? terminalCount + grammar.ordinal(symbol) : grammar.ordinal(symbol);
+    };
+    std::vector<uint32_t> bodyStart = {0};
+    std::vector<uint32_t> bodies;
+    for (uint32_t production = 0; production < productions; production++)
+    {
+        for (const Grammar::Symbol *symbol = grammar.bodyBegin(production); symbol != grammar.bodyEnd(production);
+             symbol++)
+        {
+            bodies.push_back(local(*symbol));
+        }
+        bodyStart.push_back(static_cast<uint32_t>(bodies.size()));
+        table.productionLhs.push_back(static_cast<Symbol>(grammar.ordinal(grammar.lhs(production))));
+        table.productionLength.push_back(static_cast<uint16_t>(bodyStart[production + 1] - bodyStart[production]));
+    }
+    bodies.push_back(local(grammar.startSymbol()));
+    bodyStart.push_back(static_cast<uint32_t>(bodies.size()));
+    table.productionLhs.push_back(static_cast<Symbol>(nonterminalCount));
+    table.productionLength.push_back(1);
+
+    // Itens: a producao p com o ponto na posicao d e o item itemStart[p] + d
+    std::vector<uint32_t> itemStart;
+    std::vector<uint32_t> itemProduction;
+    std::vector<uint32_t> itemNext;
+    for (uint32_t production = 0; production <= augmented; production++)
+    {
+        itemStart.push_back(static_cast<uint32_t>(itemProduction.size()));
+        for (uint32_t position = bodyStart[production]; position <= bodyStart[production + 1]; position++)
+        {
+            itemProduction.push_back(production);
+            itemNext.push_back(position < bodyStart[production + 1] ? bodies[position] : NO_NEXT);
+        }
+    }
+    size_t itemCount = itemProduction.size();
+    auto isNonterminal = [terminalCount](uint32_t symbol) { return symbol != NO_NEXT && symbol >= terminalCount; };
+    auto productionsOf = [&grammar, terminalCount](uint32_t symbol) {
+        return grammar.productionsOf(grammar.nonterminals()[symbol - terminalCount]);
+    };
+
+    // Colecao LR(0): estados pelo nucleo, fechamento so quando o estado e visitado
+    std::vector<uint32_t> added(nonterminalCount, 0);
+    uint32_t stamp = 0;
+    auto closure = [&](const std::vector<uint32_t> &kernel, std::vector<uint32_t> &items) {
+        items = kernel;
+        stamp++;
+        for (size_t i = 0; i < items.size(); i++)
+        {
+            uint32_t symbol = itemNext[items[i]];
+            if (!isNonterminal(symbol) || added[symbol - terminalCount] == stamp)
+            {
+                continue;
+            }
+            added[symbol - terminalCount] = stamp;
+            auto [first, last] = productionsOf(symbol);
+            for (uint32_t production = first; production < last; production++)
+            {
+                items.push_back(itemStart[production]);
+            }
+        }
+    };
+
+    struct Transition
+    {
+        uint32_t symbol;
+        uint32_t target;
+    };
+    std::vector<std::vector<uint32_t>> kernels = {{itemStart[augmented]}};
+    std::unordered_map<std::vector<uint32_t>, uint32_t, KernelHash> stateOf = {{kernels[0], 0}};
+    std::vector<std::vector<Transition>> transitions;
+    std::vector<std::vector<uint32_t>> buckets(terminalCount + nonterminalCount);
+    std::vector<uint32_t> touched;
+    std::vector<uint32_t> items;
+    for (size_t state = 0; state < kernels.size(); state++)
+    {
+        closure(kernels[state], items);
+        touched.clear();
+        for (uint32_t item : items)
+        {
+            uint32_t symbol = itemNext[item];
+            if (symbol == NO_NEXT)
+            {
+                continue;
+            }
+            if (buckets[symbol].empty())
+            {
+                touched.push_back(symbol);
+            }
+            buckets[symbol].push_back(item + 1);
+        }
+
+        std::vector<Transition> out;
+        for (uint32_t symbol : touched)
+        {
+            std::vector<uint32_t> &kernel = buckets[symbol];
+            std::sort(kernel.begin(), kernel.end());
+            auto [it, inserted] = stateOf.emplace(kernel, static_cast<uint32_t>(kernels.size()));
+            if (inserted)
+            {
+                kernels.push_back(kernel);
+            }
+            out.push_back({symbol, it->second});
+            kernel.clear();
+        }
+        transitions.push_back(std::move(out));
+    }
+    size_t stateCount = kernels.size();
+    auto targetOf = [&transitions](size_t state, uint32_t symbol) {
+        for (const Transition &transition : transitions[state])
+        {
+            if (transition.symbol == symbol)
+            {
+                return transition.target;
+            }
+        }
+        return NO_NEXT;
+    };
+
+    // Lookaheads em bits: colunas dos terminais e, na ultima, o lookahead
+    // ficticio usado para descobrir o que se propaga
+    const uint32_t dummy = terminalCount;
+    const size_t words = (terminalCount + 1 + 63) / 64;
+    Grammar::Analysis analysis = grammar.analyze();
+
+    // FIRST do que vem depois do simbolo apos o ponto, por item
+    std::vector<uint64_t> restFirst(itemCount * words, 0);
+    std::vector<uint8_t> restNullable(itemCount, 1);
+    for (uint32_t production = 0; production < productions; production++)
+    {
+        size_t length = bodyStart[production + 1] - bodyStart[production];
+        for (size_t dot = 0; dot < length; dot++)
+        {
+            uint32_t item = itemStart[production] + static_cast<uint32_t>(dot);
+            restNullable[item] = grammar.firstOfSequence(analysis, grammar.bodyBegin(production) + dot + 1,
+                                                         grammar.bodyEnd(production), restFirst.data() + item * words);
+        }
+    }
+
+    // Fechamento LR(1): cada item do fechamento com o seu conjunto de lookaheads
+    std::vector<uint32_t> slotOf(itemCount, 0);
+    std::vector<uint32_t> slotStamp(itemCount, 0);
+    std::vector<uint32_t> closureItems;
+    std::vector<uint64_t> closureLookaheads;
+    std::vector<uint8_t> queued;
+    std::vector<uint32_t> pending;
+    std::vector<uint64_t> spread(words);
+    auto addItem = [&](uint32_t item, const uint64_t *lookaheads) {
+        if (slotStamp[item] != stamp)
+        {
+            slotStamp[item] = stamp;
+            slotOf[item] = static_cast<uint32_t>(closureItems.size());
+            closureItems.push_back(item);
+            closureLookaheads.insert(closureLookaheads.end(), lookaheads, lookaheads + words);
+            queued.push_back(1);
+            pending.push_back(slotOf[item]);
+            return;
+        }
+        uint32_t slot = slotOf[item];
+        uint64_t changed = 0;
+        for (size_t w = 0; w < words; w++)
+        {
+            uint64_t merged = closureLookaheads[slot * words + w] | lookaheads[w];
+            changed |= merged ^ closureLookaheads[slot * words + w];
+            closureLookaheads[slot * words + w] = merged;
+        }
+        if (changed && !queued[slot])
+        {
+            queued[slot] = 1;
+            pending.push_back(slot);
+        }
+    };
+    auto closeLR1 = [&]() {
+        while (!pending.empty())
+        {
+            uint32_t slot = pending.back();
+            pending.pop_back();
+            queued[slot] = 0;
+            uint32_t item = closureItems[slot];
+            uint32_t symbol = itemNext[item];
+            if (!isNonterminal(symbol))
+            {
+                continue;
+            }
+            for (size_t w = 0; w < words; w++)
+            {
+                spread[w] = restFirst[item * words + w] | (restNullable[item] ? closureLookaheads[slot * words + w] : 0);
+            }
+            auto [first, last] = productionsOf(symbol);
+            for (uint32_t production = first; production < last; production++)
+            {
+                addItem(itemStart[production], spread.data());
+            }
+        }
+    };
+    auto startClosure = [&]() {
+        stamp++;
+        closureItems.clear();
+        closureLookaheads.clear();
+        queued.clear();
+        pending.clear();
+    };
+
+    // Posicao global de cada item de nucleo
+    std::vector<uint32_t> kernelOffset(stateCount + 1, 0);
+    for (size_t state = 0; state < stateCount; state++)
+    {
+        kernelOffset[state + 1] = kernelOffset[state] + static_cast<uint32_t>(kernels[state].size());
+    }
+    std::vector<uint64_t> lookaheads(kernelOffset[stateCount] * words, 0);
+    std::vector<std::vector<uint32_t>> propagatesTo(kernelOffset[stateCount]);
+    lookaheads[0] |= 1; // S' -> . inicial, com "$"
+
+    // Espontaneos e propagacoes: fechamento de cada item de nucleo com o
+    // lookahead ficticio; o que chega ao destino sem ele e espontaneo
+    std::vector<uint64_t> dummyOnly(words, 0);
+    dummyOnly[dummy / 64] = uint64_t(1) << (dummy % 64);
+    for (size_t state = 0; state < stateCount; state++)
+    {
+        for (size_t k = 0; k < kernels[state].size(); k++)
+        {
+            startClosure();
+            addItem(kernels[state][k], dummyOnly.data());
+            closeLR1();
+            for (size_t slot = 0; slot < closureItems.size(); slot++)
+            {
+                uint32_t item = closureItems[slot];
+                if (itemNext[item] == NO_NEXT)
+                {
+                    continue;
+                }
+                uint32_t target = targetOf(state, itemNext[item]);
+                const std::vector<uint32_t> &targetKernel = kernels[target];
+                uint32_t index = kernelOffset[target] +
+                                 static_cast<uint32_t>(std::lower_bound(targetKernel.begin(), targetKernel.end(), item + 1) -
+                                                       targetKernel.begin());
+                const uint64_t *found = closureLookaheads.data() + slot * words;
+                for (size_t w = 0; w < words; w++)
+                {
+                    lookaheads[index * words + w] |= found[w] & ~dummyOnly[w];
+                }
+                if (found[dummy / 64] & dummyOnly[dummy / 64])
+                {
+                    propagatesTo[kernelOffset[state] + k].push_back(index);
+                }
+            }
+        }
+    }
+
+    // Propagacao ate o ponto fixo
+    std::vector<uint32_t> worklist(kernelOffset[stateCount]);
+    std::iota(worklist.begin(), worklist.end(), 0);
+    std::vector<uint8_t> inWorklist(kernelOffset[stateCount], 1);
+    while (!worklist.empty())
+    {
+        uint32_t from = worklist.back();
+        worklist.pop_back();
+        inWorklist[from] = 0;
+        for (uint32_t to : propagatesTo[from])
+        {
+            uint64_t changed = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t merged = lookaheads[to * words + w] | lookaheads[from * words + w];
+                changed |= merged ^ lookaheads[to * words + w];
+                lookaheads[to * words + w] = merged;
+            }
+            if (changed && !inWorklist[to])
+            {
+                inWorklist[to] = 1;
+                worklist.push_back(to);
+            }
+        }
+    }
+
+    // Nomes dos terminais e mapeamento token -> terminal
+    for (Grammar::Symbol terminal : grammar.terminals())
+    {
+        table.terminalNames.push_back(grammar.name(terminal));
+    }
+    Symbol unknown = static_cast<Symbol>(table.terminalNames.size());
+    table.terminalNames.push_back("?");
+    auto lookup = [&table, unknown](std::string_view name) {
+        for (Symbol terminal = 0; terminal < unknown; terminal++)
+        {
+            if (table.terminalNames[terminal] == name)
+            {
+                return terminal;
+            }
+        }
+        return unknown;
+    };
+    table.terminals = TerminalMap::fromNames(0, unknown, lookup);
+    table.terminalKeywords.assign(table.terminalNames.size(), Keyword::NONE);
+    for (size_t k = 1; k < TerminalMap::KEYWORDS; k++)
+    {
+        if (table.terminals.keywordTerminals[k] != unknown)
+        {
+            table.terminalKeywords[table.terminals.keywordTerminals[k]] = static_cast<Keyword>(k);
+        }
+    }
+
+    auto productionText = [&](uint32_t production) {
+        std::string text = production == augmented ? grammar.name(grammar.startSymbol()) + "'"
+                                                   : grammar.name(grammar.lhs(production));
+        text += " ->";
+        if (bodyStart[production] == bodyStart[production + 1])
+        {
+            return text + " ε";
+        }
+        for (uint32_t position = bodyStart[production]; position < bodyStart[production + 1]; position++)
+        {
+            uint32_t symbol = bodies[position];
+            text += " ";
+            text += symbol < terminalCount ? table.terminalNames[symbol]
+                                           : grammar.name(grammar.nonterminals()[symbol - terminalCount]);
+        }
+        return text;
+    };
+
+    // ACTION: empilhamentos pelas transicoes, reducoes pelo fechamento LR(1)
+    // do nucleo com os lookaheads finais (os itens ε fora do nucleo tambem)
+    size_t columns = table.terminalNames.size();
+    std::vector<SparseRow> actionRows(stateCount);
+    std::vector<SparseRow> gotoRows(nonterminalCount);
+    std::vector<Action> row(columns, ERROR);
+    for (size_t state = 0; state < stateCount; state++)
+    {
+        std::fill(row.begin(), row.end(), ERROR);
+        for (const Transition &transition : transitions[state])
+        {
+            if (transition.symbol < terminalCount)
+            {
+                row[transition.symbol] = static_cast<Action>(transition.target + 1);
+            }
+            else
+            {
+                gotoRows[transition.symbol - terminalCount].emplace_back(static_cast<int32_t>(state),
+                                                                         static_cast<int16_t>(transition.target));
+            }
+        }
+
+        startClosure();
+        for (size_t k = 0; k < kernels[state].size(); k++)
+        {
+            addItem(kernels[state][k], lookaheads.data() + (kernelOffset[state] + k) * words);
+        }
+        closeLR1();
+        for (size_t slot = 0; slot < closureItems.size(); slot++)
+        {
+            uint32_t item = closureItems[slot];
+            if (itemNext[item] != NO_NEXT)
+            {
+                continue;
+            }
+            uint32_t production = itemProduction[item];
+            Action reduce = static_cast<Action>(-static_cast<int32_t>(production) - 1);
+            for (uint32_t terminal = 0; terminal < terminalCount; terminal++)
+            {
+                if (!((closureLookaheads[slot * words + terminal / 64] >> (terminal % 64)) & 1))
+                {
+                    continue;
+                }
+                Action &cell = row[terminal];
+                if (cell == ERROR)
+                {
+                    cell = reduce;
+                }
+                else if (isShift(cell))
+                {
+                    table.conflicts.push_back({static_cast<uint32_t>(state), table.terminalNames[terminal], "shift",
+                                               "reduce " + productionText(production)});
+                }
+                else if (cell != reduce)
+                {
+                    uint32_t current = static_cast<uint32_t>(reduceProduction(cell));
+                    uint32_t kept = std::min(current, production);
+                    uint32_t discarded = std::max(current, production);
+                    table.conflicts.push_back({static_cast<uint32_t>(state), table.terminalNames[terminal],
+                                               "reduce " + productionText(kept),
+                                               "reduce " + productionText(discarded)});
+                    cell = static_cast<Action>(-static_cast<int32_t>(kept) - 1);
+                }
+            }
+        }
+
+        for (size_t terminal = 0; terminal < columns; terminal++)
+        {
+            if (row[terminal] != ERROR)
+            {
+                actionRows[state].emplace_back(static_cast<int32_t>(terminal), row[terminal]);
+            }
+        }
+    }
+
+    // Acao padrao: a reducao mais frequente (nunca a aceitacao, que so vale
+    // com "$"); as entradas iguais a ela saem da linha
+    Action accept = static_cast<Action>(-static_cast<int32_t>(augmented) - 1);
+    table.actionDefault.resize(stateCount);
+    for (size_t state = 0; state < stateCount; state++)
+    {
+        SparseRow &entries = actionRows[state];
+        Action fallback = mostFrequent(entries, ERROR, [accept](int16_t action) { return action < 0 && action != accept; });
+        table.actionDefault[state] = fallback;
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [fallback](const auto &entry) { return entry.second == fallback; }),
+                      entries.end());
+    }
+    displaceRows(actionRows, columns, table.actionBase, table.actionValue, table.actionCheck);
+
+    // GOTO por nao-terminal, indexado pelo estado de origem
+    table.gotoDefault.resize(nonterminalCount);
+    for (size_t nonterminal = 0; nonterminal < nonterminalCount; nonterminal++)
+    {
+        SparseRow &entries = gotoRows[nonterminal];
+        State fallback = mostFrequent(entries, 0, [](int16_t) { return true; });
+        table.gotoDefault[nonterminal] = fallback;
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [fallback](const auto &entry) { return entry.second == fallback; }),
+                      entries.end());
+    }
+    displaceRows(gotoRows, stateCount, table.gotoBase, table.gotoValue, table.gotoCheck);
+
+    return table;
+}
+
+LALRTable LALRTable::fromLanguageGrammar()
+{
+    return build(Grammar::fromRules(getGramatica(), "programa"));
+}
+
+size_t LALRTable::compressedBytes() const
+{
+    return actionBase.size() * sizeof(int32_t) + actionDefault.size() * sizeof(Action) +
+           actionValue.size() * sizeof(Action) + actionCheck.size() * sizeof(State) +
+           gotoBase.size() * sizeof(int32_t) + gotoDefault.size() * sizeof(State) + gotoValue.size() * sizeof(State) +
+           gotoCheck.size() * sizeof(Symbol);
+}
+
+size_t LALRTable::denseBytes() const
+{
+    return stateCount() * (terminalNames.size() * sizeof(Action) + nonterminalCount * sizeof(State));
+}
+
+void LALRTable::report(std::ostream &out) const
+{
+    out << "LALR(1): " << stateCount() << " states, " << terminalNames.size() << " terminals, " << nonterminalCount
+        << " nonterminals, " << productionLhs.size() - 1 << " productions, " << conflicts.size() << " conflicts"
+        << std::endl;
+    out << "tables: " << compressedBytes() << " bytes compressed, " << denseBytes() << " bytes dense" << std::endl;
+    for (const LALRConflict &conflict : conflicts)
+    {
+        out << "conflict in state " << conflict.state << " on " << conflict.terminal << ": kept '" << conflict.kept
+            << "' over '" << conflict.discarded << "'" << std::endl;
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef LALR_TABLE_H
+#define LALR_TABLE_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../lexical/Token/Token.h"
+#include "../TerminalMap.h"
+#include "../utils/Grammar.h"
+
+// Acao disputada por duas alternativas num estado. Empilhar vence reduzir (o
+// else pendente fica com o if mais interno); entre reducoes vence a producao
+// que vem primeiro.
+struct LALRConflict
+{
+    uint32_t state;
+    std::string terminal;
+    std::string kept;
+    std::string discarded;
+};
+
+// Tabelas LALR(1) geradas direto de uma Grammar, sem reescrever a gramatica:
+// recursao a esquerda e natural para um analisador ascendente. Colecao LR(0)
+// dos conjuntos de itens, lookaheads por propagacao (espontaneos e
+// propagados, calculados com um lookahead ficticio) e as tabelas ACTION e
+// GOTO comprimidas por deslocamento de linhas: cada linha tem uma base num
+// vetor compartilhado, check diz a qual linha a posicao pertence e o que nao
+// esta la e a acao padrao da linha (a reducao mais frequente do estado,
+// nunca a de aceitar, ou erro; no GOTO, o destino mais frequente do
+// nao-terminal).
+//
+// Terminais usam os ordinais da Grammar ("$" e 0), com "?" no fim para
+// tokens que nao aparecem na gramatica; nao-terminais usam os seus ordinais.
+// Estados e producoes cabem em int16_t, como na LL1Table.
+class LALRTable
+{
+public:
+    using Symbol = int16_t;
+    using State = int16_t;
+    using Action = int16_t;
+
+    static constexpr Action ERROR = 0;
+
+    static LALRTable build(const Grammar &grammar);
+    // getGramatica() como esta, com "programa" de inicial
+    static LALRTable fromLanguageGrammar();
+
+    // Acao codificada: > 0 empilha e vai para o estado action - 1; < 0 reduz
+    // pela producao -action - 1 (a producao aumentada, acceptProduction(),
+    // aceita); ERROR e erro
+    Action action(State state, Symbol terminal) const
+    {
+        int32_t slot = actionBase[state] + terminal;
+        return actionCheck[slot] == state ? actionValue[slot] : actionDefault[state];
+    }
+    State gotoState(State state, Symbol nonterminal) const
+    {
+        int32_t slot = gotoBase[nonterminal] + state;
+        return gotoCheck[slot] == nonterminal ? gotoValue[slot] : gotoDefault[nonterminal];
+    }
+    static bool isShift(Action action) { return action > 0; }
+    static State shiftTarget(Action action) { return static_cast<State>(action - 1); }
+    static int16_t reduceProduction(Action action) { return static_cast<int16_t>(-action - 1); }
+
+    int16_t acceptProduction() const { return static_cast<int16_t>(productionLhs.size() - 1); }
+    // Nao-terminal do lado esquerdo e tamanho do corpo
+    Symbol lhs(int16_t production) const { return productionLhs[production]; }
+    uint16_t length(int16_t production) const { return productionLength[production]; }
+
+    Symbol terminalOf(const Token &token) const { return terminals.terminalOf(token); }
+    Symbol endMarker() const { return terminals.end; }
+    Symbol terminalCount() const { return static_cast<Symbol>(terminalNames.size()); }
+    size_t stateCount() const { return actionDefault.size(); }
+    std::string_view terminalName(Symbol terminal) const { return terminalNames[terminal]; }
+    // Palavra-chave ou pontuacao do terminal, para as mensagens de erro
+    Keyword keywordOf(Symbol terminal) const { return terminalKeywords[terminal]; }
+
+    const std::vector<LALRConflict> &getConflicts() const { return conflicts; }
+    // Bytes das tabelas comprimidas e das mesmas tabelas sem compressao
+    size_t compressedBytes() const;
+    size_t denseBytes() const;
+    void report(std::ostream &out) const;
+
+private:
+    TerminalMap terminals;
+    std::vector<std::string> terminalNames;
+    std::vector<Keyword> terminalKeywords;
+    size_t nonterminalCount = 0;
+
+    // A ultima producao e a aumentada, S' -> inicial
+    std::vector<Symbol> productionLhs;
+    std::vector<uint16_t> productionLength;
+
+    std::vector<int32_t> actionBase;
+    std::vector<Action> actionDefault;
+    std::vector<Action> actionValue;
+    std::vector<State> actionCheck;
+
+    std::vector<int32_t> gotoBase;
+    std::vector<State> gotoDefault;
+    std::vector<State> gotoValue;
+    std::vector<Symbol> gotoCheck;
+
+    std::vector<LALRConflict> conflicts;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#include "ShiftReduceParser.h"
+#include <stdexcept>
+
+ShiftReduceParser::ShiftReduceParser(TokenCursor &tokens, const LALRTable &table) : tokens(tokens), table(table) {}
+
+void ShiftReduceParser::advance()
+{
+    currentToken = tokens.next();
+    lookahead = table.terminalOf(currentToken);
+}
+
+bool ShiftReduceParser::parse()
+{
+    stack.clear();
+    stack.push_back(0);
+    advance();
+
+    for (;;)
+    {
+        LALRTable::Action action = table.action(stack.back(), lookahead);
+        if (LALRTable::isShift(action))
+        {
+            stack.push_back(LALRTable::shiftTarget(action));
+            panicking = false;
+            advance();
+            continue;
+        }
+
+        if (action != LALRTable::ERROR)
+        {
+            int16_t production = LALRTable::reduceProduction(action);
+            if (production == table.acceptProduction())
+            {
+                break;
+            }
+            stack.resize(stack.size() - table.length(production));
+            stack.push_back(table.gotoState(stack.back(), table.lhs(production)));
+            continue;
+        }
+
+        if (!reportUnexpected(stack.back()) || !recover())
+        {
+            break;
+        }
+    }
+
+    return diagnostics.empty();
+}
+
+__attribute__((cold)) bool ShiftReduceParser::recover()
+{
+    for (;;)
+    {
+        for (size_t depth = stack.size(); depth-- > 0;)
+        {
+            if (LALRTable::isShift(table.action(stack[depth], lookahead)))
+            {
+                stack.resize(depth + 1);
+                return true;
+            }
+        }
+        if (lookahead == table.endMarker())
+        {
+            return false;
+        }
+        advance();
+    }
+}
+
+// Com um so terminal possivel no estado, a mensagem diz qual
+__attribute__((cold)) bool ShiftReduceParser::reportUnexpected(State state)
+{
+    Symbol expected = -1;
+    int candidates = 0;
+    for (Symbol terminal = 0; terminal < table.terminalCount(); terminal++)
+    {
+        if (LALRTable::isShift(table.action(state, terminal)))
+        {
+            expected = terminal;
+            candidates++;
+        }
+    }
+    if (candidates == 1)
+    {
+        Keyword keyword = table.keywordOf(expected);
+        if (keyword != Keyword::NONE)
+        {
+            return report(SyntaxErrorCode::EXPECTED_KEYWORD, keyword);
+        }
+        if (table.terminalName(expected) == "id")
+        {
+            return report(SyntaxErrorCode::UNEXPECTED_TOKEN_TYPE, Keyword::NONE, TokenType::IDENTIFIER);
+        }
+    }
+    return report(SyntaxErrorCode::UNEXPECTED_TOKEN);
+}
+
+__attribute__((cold)) bool ShiftReduceParser::report(SyntaxErrorCode code, Keyword expectedKeyword, TokenType expectedType)
+{
+    if (panicking)
+    {
+        return true;
+    }
+    panicking = true;
+    diagnostics.push_back({currentToken.getOffset(), static_cast<uint32_t>(currentToken.getText().size()), code,
+                           expectedKeyword, expectedType, tokens.locate(currentToken.getOffset())});
+    return diagnostics.size() < errorLimit;
+}
+
+const std::vector<SyntaxDiagnostic> &ShiftReduceParser::getDiagnostics() const
+{
+    return diagnostics;
+}
+
+void ShiftReduceParser::setErrorLimit(size_t limit)
+{
+    if (limit == 0)
+    {
+        throw std::out_of_range("error limit must be at least 1");
+    }
+    errorLimit = limit;
+}
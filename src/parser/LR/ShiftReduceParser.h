@@ -0,0 +1,46 @@
+#ifndef SHIFT_REDUCE_PARSER_H
+#define SHIFT_REDUCE_PARSER_H
+
+#include <vector>
+
+#include "../../lexical/TokenBuffer/TokenBuffer.h"
+#include "../SyntaxDiagnostic.h"
+#include "LALRTable.h"
+
+// Analisador ascendente dirigido pela LALRTable: pilha de estados explicita,
+// empilha ou reduz conforme a ACTION e desvia pela GOTO. So reconhece o
+// programa; nao monta a arvore. Os erros seguem o modelo do Parser (modo
+// panico com limite de diagnosticos): descarta tokens ate um que algum
+// estado da pilha consiga empilhar e volta a esse estado.
+class ShiftReduceParser
+{
+public:
+    ShiftReduceParser(TokenCursor &tokens, const LALRTable &table);
+    // true se o programa foi aceito sem erros
+    bool parse();
+    const std::vector<SyntaxDiagnostic> &getDiagnostics() const;
+    // Como Parser::setErrorLimit
+    void setErrorLimit(size_t limit);
+
+private:
+    using Symbol = LALRTable::Symbol;
+    using State = LALRTable::State;
+
+    TokenCursor &tokens;
+    const LALRTable &table;
+    Token currentToken;
+    Symbol lookahead = 0;
+    std::vector<State> stack;
+    std::vector<SyntaxDiagnostic> diagnostics;
+    size_t errorLimit = 25;
+    bool panicking = false;
+
+    void advance();
+    // false quando nao ha token que a pilha aceite ate o fim da entrada
+    bool recover();
+    // Guarda o erro; false quando o limite foi atingido e a analise deve parar
+    bool report(SyntaxErrorCode code, Keyword expectedKeyword = Keyword::NONE, TokenType expectedType = TokenType::NONE);
+    bool reportUnexpected(State state);
+};
+
+#endif
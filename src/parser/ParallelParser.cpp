@@ -0,0 +1,245 @@
+#include "Parser.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+// Analisa em paralelo os procedimentos do nivel mais externo, em duas fases.
+// Uma passada linear pelas keywords casa procedure com o begin/end do corpo e
+// acha o trecho de tokens de cada procedimento; depois os trechos sao
+// analisados por um pool de threads, cada uma montando os nos na sua arena.
+// parseProgram segue sequencial e, ao chegar a um procedimento ja analisado,
+// copia para a arvore os nos dele e dos seguintes (Ast::place, tambem em
+// paralelo) e pula os tokens. Um procedimento sem erros gera os mesmos nos
+// sozinho ou dentro do programa, so com os indices deslocados; os que tiveram
+// erro sao refeitos ali mesmo, entao arvore e diagnosticos sao os da analise
+// sequencial.
+
+namespace
+{
+    struct TokenRange
+    {
+        size_t begin;
+        size_t end;
+    };
+
+    // Trechos consecutivos analisados pela mesma thread, um apos o outro
+    struct Task
+    {
+        size_t first;
+        size_t last;
+    };
+
+    // Do "procedure" ao ";" depois do end do corpo, ate o begin do programa.
+    // Num trecho mal formado a analise da erro e o procedimento fica para o
+    // Parser sequencial.
+    std::vector<TokenRange> findSubprograms(const TokenBuffer &tokens)
+    {
+        std::vector<TokenRange> ranges;
+        // Um contador de begins abertos por procedimento aninhado ainda sem o
+        // corpo fechado
+        std::vector<uint32_t> open;
+        size_t start = 0;
+        const Keyword *keywords = tokens.keywords.data();
+        for (size_t i = 0; i < tokens.size(); i++)
+        {
+            switch (keywords[i])
+            {
+            case Keyword::PROCEDURE:
+                if (open.empty())
+                {
+                    start = i;
+                }
+                open.push_back(0);
+                break;
+            case Keyword::BEGIN:
+                if (open.empty())
+                {
+                    // Corpo do programa
+                    return ranges;
+                }
+                open.back()++;
+                break;
+            case Keyword::END:
+                if (open.empty() || open.back() == 0)
+                {
+                    return ranges;
+                }
+                if (--open.back() == 0)
+                {
+                    open.pop_back();
+                    if (open.empty())
+                    {
+                        size_t end = i + 1;
+                        if (end < tokens.size() && keywords[end] == Keyword::SEMICOLON)
+                        {
+                            end++;
+                        }
+                        ranges.push_back({start, end});
+                    }
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        return ranges;
+    }
+
+    uint32_t offsetAt(const TokenBuffer &tokens, size_t index)
+    {
+        return index < tokens.size() ? tokens.offsets[index] : tokens.endOffset;
+    }
+
+    // work(thread) em threads threads, a que chama inclusive
+    template <typename Work>
+    void onThreads(unsigned threads, const Work &work)
+    {
+        std::vector<std::thread> pool;
+        for (unsigned thread = 1; thread < threads; thread++)
+        {
+            pool.emplace_back(work, thread);
+        }
+        work(0u);
+        for (std::thread &thread : pool)
+        {
+            thread.join();
+        }
+    }
+
+    // Abaixo disso copiar os procedimentos numa thread so sai mais barato
+    constexpr size_t PARALLEL_PLACE_NODES = 64 * 1024;
+}
+
+void Parser::prepareSubprograms(const TokenBuffer &buffer, unsigned threads)
+{
+    prepared.clear();
+    nextPrepared = 0;
+    std::vector<TokenRange> ranges = findSubprograms(buffer);
+    if (ranges.size() < 2)
+    {
+        return;
+    }
+
+    // Mais tarefas que threads para equilibrar a carga; procedimentos
+    // pequenos sao agrupados para amortizar a criacao do Parser de cada tarefa
+    size_t total = ranges.back().end - ranges.front().begin;
+    size_t taskTokens = total / (threads * 4) + 1;
+    std::vector<Task> tasks;
+    for (size_t first = 0; first < ranges.size();)
+    {
+        size_t last = first + 1;
+        while (last < ranges.size() && ranges[last].end - ranges[first].begin <= taskTokens)
+        {
+            last++;
+        }
+        tasks.push_back({first, last});
+        first = last;
+    }
+
+    threads = static_cast<unsigned>(std::min<size_t>(threads, tasks.size()));
+    arenas.resize(threads);
+    for (Ast &arena : arenas)
+    {
+        arena.clear();
+    }
+    // tokenCount 0: nao preparado
+    std::vector<PreparedSubprogram> results(ranges.size(), PreparedSubprogram{0, 0, 0, 0, {}});
+
+    std::atomic<size_t> nextTask(0);
+    onThreads(threads, [&](unsigned arena) {
+        Ast &part = arenas[arena];
+        size_t index;
+        while ((index = nextTask++) < tasks.size())
+        {
+            const Task &task = tasks[index];
+            TokenCursor cursor(buffer, ranges[task.first].begin, ranges[task.last - 1].end);
+            Parser parser(cursor, part);
+            // Basta o primeiro erro para desistir do resto da tarefa
+            parser.setErrorLimit(1);
+            for (size_t r = task.first; r < task.last; r++)
+            {
+                NodeId nodeBegin = static_cast<NodeId>(part.size());
+                uint32_t extraBegin = static_cast<uint32_t>(part.extra.size());
+                parser.parseSubprogram();
+                if (!parser.diagnostics.empty() || parser.currentToken.getOffset() != offsetAt(buffer, ranges[r].end))
+                {
+                    break;
+                }
+                AstRange range{nodeBegin, static_cast<NodeId>(part.size()), extraBegin,
+                               static_cast<uint32_t>(part.extra.size())};
+                results[r] = {buffer.offsets[ranges[r].begin], static_cast<uint32_t>(ranges[r].begin),
+                              static_cast<uint32_t>(ranges[r].end - ranges[r].begin), arena, range};
+            }
+        }
+    });
+
+    for (const PreparedSubprogram &result : results)
+    {
+        if (result.tokenCount != 0)
+        {
+            prepared.push_back(result);
+        }
+    }
+}
+
+bool Parser::takePreparedSubprograms()
+{
+    // Em modo panico a analise sequencial do procedimento poderia ser outra
+    if (panicking)
+    {
+        return false;
+    }
+    uint32_t offset = currentToken.getOffset();
+    while (nextPrepared < prepared.size() && prepared[nextPrepared].offset < offset)
+    {
+        nextPrepared++;
+    }
+    if (nextPrepared == prepared.size() || prepared[nextPrepared].offset != offset)
+    {
+        return false;
+    }
+
+    // O Parser tomaria um apos o outro os que comecam onde o anterior
+    // termina; as posicoes de cada um na arvore saem das somas dos tamanhos
+    size_t first = nextPrepared;
+    size_t last = first + 1;
+    while (last < prepared.size() &&
+           prepared[last].token == prepared[last - 1].token + prepared[last - 1].tokenCount)
+    {
+        last++;
+    }
+    std::vector<NodeId> nodeAt(last - first + 1);
+    std::vector<uint32_t> extraAt(last - first + 1);
+    nodeAt[0] = static_cast<NodeId>(ast.size());
+    extraAt[0] = static_cast<uint32_t>(ast.extra.size());
+    for (size_t i = first; i < last; i++)
+    {
+        const AstRange &range = prepared[i].range;
+        nodeAt[i - first + 1] = nodeAt[i - first] + (range.nodeEnd - range.nodeBegin);
+        extraAt[i - first + 1] = extraAt[i - first] + (range.extraEnd - range.extraBegin);
+    }
+    ast.grow(nodeAt.back() - nodeAt[0], extraAt.back() - extraAt[0]);
+
+    size_t nodes = nodeAt.back() - nodeAt[0];
+    unsigned threads = nodes < PARALLEL_PLACE_NODES ? 1 : static_cast<unsigned>(arenas.size());
+    std::atomic<size_t> next(first);
+    onThreads(threads, [&](unsigned) {
+        size_t i;
+        while ((i = next++) < last)
+        {
+            const PreparedSubprogram &subprogram = prepared[i];
+            ast.place(arenas[subprogram.arena], subprogram.range, nodeAt[i - first], extraAt[i - first]);
+        }
+    });
+
+    // O PROCEDURE e o ultimo no de cada trecho
+    for (size_t i = first; i < last; i++)
+    {
+        ast.pushItem(nodeAt[i - first + 1] - 1);
+    }
+    size_t tokenCount = prepared[last - 1].token + prepared[last - 1].tokenCount - prepared[first].token;
+    tokens.skip(tokenCount - 1);
+    currentToken = tokens.next();
+    nextPrepared = last;
+    return true;
+}
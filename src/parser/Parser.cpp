@@ -1,325 +1,643 @@
 #include "Parser.h"
 #include <iostream>
+#include <stdexcept>
+#include <thread>
 
 
 // CODIGO PRECISANDO DE MUITOS AJUSTES AINDA
 
-Parser::Parser(Scanner &scanner) : scanner(scanner)
+namespace
 {
-   currentToken = scanner.getCurrentToken();
+    // Tokens a partir dos quais o modo paralelo compensa o custo das threads
+    constexpr size_t DEFAULT_PARALLEL_THRESHOLD = 1024 * 1024;
+
+    // Precedencia dos operadores de expressao; 0 = nao e operador binario
+    constexpr uint8_t RELATION_PRECEDENCE = 1;
+    constexpr uint8_t ADDITIVE_PRECEDENCE = 2;
+    constexpr uint8_t MULTIPLICATIVE_PRECEDENCE = 3;
+    constexpr uint8_t NOT_PRECEDENCE = 4;
+
+    constexpr uint8_t binaryPrecedence(TokenType type)
+    {
+        switch (type)
+        {
+        case TokenType::REL_OPERATOR:
+        case TokenType::EQUAL_OPERATOR:
+            return RELATION_PRECEDENCE;
+        case TokenType::ADD_OPERATOR:
+            return ADDITIVE_PRECEDENCE;
+        case TokenType::MULT_OPERATOR:
+            return MULTIPLICATIVE_PRECEDENCE;
+        default:
+            return 0;
+        }
+    }
+
+    // Operador de um token REL/ADD/MULT_OPERATOR ou LOGICAL_OPERATOR
+    Operator classifyOperator(const Token &token)
+    {
+        std::string_view text = token.getText();
+        switch (token.getKeyword())
+        {
+        case Keyword::AND:
+            return Operator::AND;
+        case Keyword::OR:
+            return Operator::OR;
+        default:
+            break;
+        }
+        if (text.empty())
+        {
+            return Operator::NONE;
+        }
+        switch (text[0])
+        {
+        case '+':
+            return Operator::ADD;
+        case '-':
+            return Operator::SUBTRACT;
+        case '*':
+            return Operator::MULTIPLY;
+        case '/':
+            return Operator::DIVIDE;
+        case '<':
+            if (text.size() > 1)
+            {
+                return text[1] == '>' ? Operator::NOT_EQUAL : Operator::LESS_EQUAL;
+            }
+            return Operator::LESS;
+        case '>':
+            return text.size() > 1 ? Operator::GREATER_EQUAL : Operator::GREATER;
+        case '!':
+            return Operator::NOT_EQUAL;
+        default:
+            return Operator::EQUAL;
+        }
+    }
+}
+
+Parser::Parser(TokenCursor &cursor, Ast &ast)
+    : tokens(cursor), ast(ast), parallelThreshold(DEFAULT_PARALLEL_THRESHOLD)
+{
+    currentToken = tokens.next();
 }
 
-void Parser::parseProgram()
+NodeId Parser::parseProgram()
 {
-    std::cout << "Entering parseProgram" << std::endl;
-    
-    std::cout << "First token in parseProgram: " << currentToken.getText() << std::endl;
+    trace.enter("parseProgram", currentToken);
+
+    const TokenBuffer *buffer = tokens.wholeBuffer();
+    if (buffer != nullptr && buffer->size() >= parallelThreshold)
+    {
+        unsigned threads = parallelThreads ? parallelThreads : std::thread::hardware_concurrency();
+        if (threads > 1)
+        {
+            prepareSubprograms(*buffer, threads);
+        }
+    }
 
     // Consome o token "program"
-    if (currentToken.getText() == "program")
+    if (currentToken.getKeyword() == Keyword::PROGRAM)
     {
-        match("program");
+        uint32_t offset = currentToken.getOffset();
+        match(Keyword::PROGRAM);
+        SymbolId name = currentToken.getSymbol();
         match(TokenType::IDENTIFIER);
         // Consome o token ";"
-        match(";");
+        match(Keyword::SEMICOLON);
 
         // Agora, prossegue para as outras partes do programa
-        parseDeclarations();
-        parseSubprogramDeclarations();
-        parseCompoundCommand();
+        uint32_t declarations = parseDeclarations();
+        uint32_t subprograms = parseSubprogramDeclarations();
+        NodeId body = parseCompoundCommand();
 
         // Verifica se o programa termina com "."
-        match(".");
+        match(Keyword::DOT);
+
+        ast.root = ast.add(NodeKind::PROGRAM, offset, name, ast.addExtra({declarations, subprograms, body}));
+        return ast.root;
     }
     else
     {
-        error("Expected 'program'");
+        error(SyntaxErrorCode::EXPECTED_PROGRAM);
+        return NO_NODE;
     }
 }
 
-void Parser::match(const std::string &expected)
+void Parser::match(Keyword expected)
 {
-    std::cout << "Matching: |" << expected << "| with |" << currentToken.getText() << "|" << std::endl;
+    trace.matchText(keywordText(expected), currentToken);
 
-    if (currentToken.getText().compare(expected) == 0)
+    if (currentToken.getKeyword() != expected)
     {
-        std::cout << "Token matched successfully!" << std::endl;
-        currentToken = scanner.nextToken();
-        std::cout << "Next Token Text: " << currentToken.getText() << std::endl;
-    }
-    else
-    {
-        error("Expected '" + expected + "'");
+        error(SyntaxErrorCode::EXPECTED_KEYWORD, expected);
+        // A sincronizacao pode ter parado justamente no token esperado
+        if (currentToken.getKeyword() != expected)
+        {
+            return;
+        }
     }
+    panicking = false;
+    currentToken = tokens.next();
 }
 
 void Parser::match(TokenType expectedType)
 {
-    std::cout << "Expected Token Type: " << static_cast<int>(expectedType) << std::endl;
-    std::cout << "Current Token Type: " << static_cast<int>(currentToken.getType()) << std::endl;
-    std::cout << "Current Token Text: " << currentToken.getText() << std::endl;
+    trace.matchType(expectedType, currentToken);
 
-    if (currentToken.getType() == expectedType)
-    {
-        std::cout << "Token matched successfully!" << std::endl;
-        currentToken = scanner.nextToken();
-        std::cout << "Next Token Text: " << currentToken.getText() << std::endl;
-        std::cout << "Next Token Type: " << static_cast<int>(currentToken.getType()) << std::endl;
-    }
-    else
+    if (currentToken.getType() != expectedType)
     {
-        error("Unexpected token type");
+        error(SyntaxErrorCode::UNEXPECTED_TOKEN_TYPE, Keyword::NONE, expectedType);
+        if (currentToken.getType() != expectedType)
+        {
+            return;
+        }
     }
+    panicking = false;
+    currentToken = tokens.next();
 }
 
-std::string cleanString(const std::string &str)
+NodeId Parser::identifierNode()
 {
-    std::string result;
-    for (char c : str)
-    {
-        if (!isspace(c))
-        {
-            result += c;
-        }
-    }
-    return result;
+    Token name = currentToken;
+    match(TokenType::IDENTIFIER);
+    return ast.add(NodeKind::IDENTIFIER, name.getOffset(), name.getSymbol());
 }
 
-// void Parser::match(const std::string &expected)
-// {
-//     std::cout << "Matching: |" << expected << "| with |" << currentToken.getText() << "|" << std::endl;
-
-//     if (currentToken.getText().compare(expected) == 0)
-//     {
-//         std::cout << "Token matched successfully!" << std::endl;
-//         currentToken = scanner.nextToken();
-//         std::cout << "Next Token Text: " << currentToken.getText() << std::endl;
-//     }
-//     else
-//     {
-//         error("Expected '" + expected + "'");
-//     }
-// }
-
-// void Parser::match(TokenType expectedType)
-// {
-//     std::cout << "Expected Token Type: " << static_cast<int>(expectedType) << std::endl;
-//     std::cout << "Current Token Type: " << static_cast<int>(currentToken.getType()) << std::endl;
-//     std::cout << "Current Token Text: " << currentToken.getText() << std::endl;
-
-//     if (currentToken.getType() == expectedType)
-//     {
-//         std::cout << "Token matched successfully!" << std::endl;
-//         currentToken = scanner.nextToken();
-//         std::cout << "Next Token Text: " << currentToken.getText() << std::endl;
-//         std::cout << "Next Token Type: " << static_cast<int>(currentToken.getType()) << std::endl;
-//     }
-//     else
-//     {
-//         error("Unexpected token type");
-//     }
-// }
-
-void Parser::parseDeclarations()
+uint32_t Parser::parseDeclarations()
 {
-    if (currentToken.getText() == "var")
+    size_t mark = ast.beginList();
+    if (currentToken.getKeyword() == Keyword::VAR)
     {
-        match("var");
+        match(Keyword::VAR);
         parseVariableDeclarations();
     }
+    return ast.endList(mark);
 }
 
 void Parser::parseVariableDeclarations()
 {
-    parseIdentifierList();
-    match(":");
-    parseType();
-    match(";");
+    uint32_t offset = currentToken.getOffset();
+    uint32_t names = parseIdentifierList();
+    match(Keyword::COLON);
+    Keyword type = parseType();
+    match(Keyword::SEMICOLON);
+    ast.pushItem(ast.add(NodeKind::VAR_DECL, offset, names, static_cast<uint32_t>(type)));
     if (currentToken.getType() == TokenType::IDENTIFIER)
     {
         parseVariableDeclarations();
     }
 }
 
-void Parser::parseIdentifierList()
+uint32_t Parser::parseIdentifierList()
 {
-    match(TokenType::IDENTIFIER);
-    while (currentToken.getText() == ",")
+    size_t mark = ast.beginList();
+    ast.pushItem(identifierNode());
+    while (currentToken.getKeyword() == Keyword::COMMA)
     {
-        match(",");
-        match(TokenType::IDENTIFIER);
+        match(Keyword::COMMA);
+        ast.pushItem(identifierNode());
     }
+    return ast.endList(mark);
 }
 
-void Parser::parseType()
+Keyword Parser::parseType()
 {
-    if (currentToken.getText() == "integer" || currentToken.getText() == "real" || currentToken.getText() == "boolean")
+    Keyword type = currentToken.getKeyword();
+    switch (type)
     {
-        match(currentToken.getText());
+    case Keyword::INTEGER:
+    case Keyword::REAL:
+    case Keyword::BOOLEAN:
+        match(type);
+        break;
+    default:
+        error(SyntaxErrorCode::EXPECTED_TYPE);
     }
-    else
+    return type;
+}
+
+uint32_t Parser::parseSubprogramDeclarations()
+{
+    size_t mark = ast.beginList();
+    while (currentToken.getKeyword() == Keyword::PROCEDURE)
     {
-        error("Expected type");
+        if (prepared.empty() || !takePreparedSubprograms())
+        {
+            ast.pushItem(parseSubprogram());
+        }
     }
+    return ast.endList(mark);
 }
 
-void Parser::parseSubprogramDeclarations()
+// declaracao_de_subprograma seguida do ";"
+NodeId Parser::parseSubprogram()
 {
-    // Similar logic as parseDeclarations for handling subprograms
-    if (currentToken.getText() == "procedure")
+    uint32_t offset = currentToken.getOffset();
+    match(Keyword::PROCEDURE);
+    SymbolId name = currentToken.getSymbol();
+    match(TokenType::IDENTIFIER);
+    uint32_t parameters = parseArguments();
+    match(Keyword::SEMICOLON);
+    uint32_t declarations = parseDeclarations();
+    uint32_t subprograms = parseSubprogramDeclarations();
+    NodeId body = parseCompoundCommand();
+    match(Keyword::SEMICOLON);
+    return ast.add(NodeKind::PROCEDURE, offset, name, ast.addExtra({parameters, declarations, subprograms, body}));
+}
+
+// argumentos -> ( lista_de_parametros ) | vazio, com
+// lista_de_parametros -> lista_de_identificadores : tipo {; lista_de_identificadores : tipo}
+// Cada grupo vira um VAR_DECL, como nas declaracoes de variaveis
+uint32_t Parser::parseArguments()
+{
+    size_t mark = ast.beginList();
+    if (currentToken.getKeyword() == Keyword::LEFT_PAREN)
     {
-        match("procedure");
-        match(TokenType::IDENTIFIER);
-        // Handle arguments and subprogram details here
-        match(";");
-        parseDeclarations();
-        parseSubprogramDeclarations();
-        parseCompoundCommand();
-        match(";");
+        match(Keyword::LEFT_PAREN);
+        for (;;)
+        {
+            uint32_t offset = currentToken.getOffset();
+            uint32_t names = parseIdentifierList();
+            match(Keyword::COLON);
+            Keyword type = parseType();
+            ast.pushItem(ast.add(NodeKind::VAR_DECL, offset, names, static_cast<uint32_t>(type)));
+            if (currentToken.getKeyword() != Keyword::SEMICOLON)
+            {
+                break;
+            }
+            match(Keyword::SEMICOLON);
+        }
+        match(Keyword::RIGHT_PAREN);
     }
+    return ast.endList(mark);
 }
 
-void Parser::parseCompoundCommand()
+NodeId Parser::parseCompoundCommand()
 {
-    match("begin");
+    uint32_t offset = currentToken.getOffset();
+    match(Keyword::BEGIN);
+    size_t mark = ast.beginList();
     parseOptionalCommands();
-    match("end");
+    uint32_t commands = ast.endList(mark);
+    match(Keyword::END);
+    return ast.add(NodeKind::COMPOUND, offset, commands);
 }
 
-void Parser::parseOptionalCommands()
+bool Parser::startsCommand() const
 {
-    if (currentToken.getType() == TokenType::IDENTIFIER ||
-        currentToken.getText() == "if" ||
-        currentToken.getText() == "while" ||
-        currentToken.getText() == "begin")
+    if (currentToken.getType() == TokenType::IDENTIFIER)
     {
-        parseCommandList();
+        return true;
+    }
+    switch (currentToken.getKeyword())
+    {
+    case Keyword::IF:
+    case Keyword::WHILE:
+    case Keyword::BEGIN:
+        return true;
+    default:
+        return false;
     }
 }
 
-void Parser::parseCommandList()
+void Parser::parseOptionalCommands()
 {
-    parseCommand();
-    while (currentToken.getText() == ";")
+    if (startsCommand())
     {
-        match(";");
-        parseCommand();
+        parseCommandList();
     }
 }
 
-void Parser::parseCommand()
+void Parser::parseCommandList()
 {
-    if (currentToken.getType() == TokenType::IDENTIFIER)
+    ast.pushItem(parseCommand());
+    for (;;)
     {
-        // Handle assignment or procedure activation
-        match(TokenType::IDENTIFIER);
-        if (currentToken.getText() == ":=")
+        if (currentToken.getKeyword() == Keyword::SEMICOLON)
+        {
+            match(Keyword::SEMICOLON);
+        }
+        else if (startsCommand())
         {
-            match(":=");
-            parseExpression();
+            // ';' esquecido entre dois comandos: reporta e segue como se
+            // estivesse la, sem descartar o comando seguinte
+            report(SyntaxErrorCode::EXPECTED_KEYWORD, Keyword::SEMICOLON);
         }
         else
         {
-            // Handle procedure activation
-            // (procedure might be called without parameters or with parameters)
+            break;
         }
+        ast.pushItem(parseCommand());
     }
-    else if (currentToken.getText() == "if")
+}
+
+NodeId Parser::parseCommand()
+{
+    uint32_t offset = currentToken.getOffset();
+    if (currentToken.getType() == TokenType::IDENTIFIER)
     {
-        match("if");
-        parseExpression();
-        match("then");
-        parseCommand();
-        if (currentToken.getText() == "else")
+        // variavel := expressao ou ativacao_de_procedimento: decide pelo
+        // token depois do id, antes de consumir qualquer um dos dois
+        if (peek(1).getKeyword() != Keyword::ASSIGN)
         {
-            match("else");
-            parseCommand();
+            return parseProcedureActivation();
         }
+        NodeId target = identifierNode();
+        match(Keyword::ASSIGN);
+        NodeId value = parseExpression();
+        return ast.add(NodeKind::ASSIGN, offset, target, value);
     }
-    else if (currentToken.getText() == "while")
+
+    switch (currentToken.getKeyword())
     {
-        match("while");
-        parseExpression();
-        match("do");
-        parseCommand();
-    }
-    else if (currentToken.getText() == "begin")
+    case Keyword::IF:
     {
-        parseCompoundCommand();
+        match(Keyword::IF);
+        NodeId condition = parseExpression();
+        match(Keyword::THEN);
+        NodeId thenBranch = parseCommand();
+        NodeId elseBranch = NO_NODE;
+        if (currentToken.getKeyword() == Keyword::ELSE)
+        {
+            match(Keyword::ELSE);
+            elseBranch = parseCommand();
+        }
+        return ast.add(NodeKind::IF, offset, condition, ast.addExtra({thenBranch, elseBranch}));
     }
-    else
+    case Keyword::WHILE:
     {
-        error("Unrecognized command");
+        match(Keyword::WHILE);
+        NodeId condition = parseExpression();
+        match(Keyword::DO);
+        NodeId body = parseCommand();
+        return ast.add(NodeKind::WHILE, offset, condition, body);
     }
-}
-
-void Parser::parseExpression()
-{
-    parseSimpleExpression();
-    if (currentToken.getType() == TokenType::REL_OPERATOR)
-    {
-        match(currentToken.getText());
-        parseSimpleExpression();
+    case Keyword::BEGIN:
+        return parseCompoundCommand();
+    default:
+        error(SyntaxErrorCode::UNRECOGNIZED_COMMAND);
+        return NO_NODE;
     }
 }
 
-void Parser::parseSimpleExpression()
+// ativacao_de_procedimento -> id | id ( lista_de_expressoes )
+NodeId Parser::parseProcedureActivation()
 {
-    parseTerm();
-    while (currentToken.getType() == TokenType::ADD_OPERATOR)
+    uint32_t offset = currentToken.getOffset();
+    SymbolId name = currentToken.getSymbol();
+    match(TokenType::IDENTIFIER);
+    size_t mark = ast.beginList();
+    if (currentToken.getKeyword() == Keyword::LEFT_PAREN)
     {
-        match(currentToken.getText());
-        parseTerm();
+        match(Keyword::LEFT_PAREN);
+        ast.pushItem(parseExpression());
+        while (currentToken.getKeyword() == Keyword::COMMA)
+        {
+            match(Keyword::COMMA);
+            ast.pushItem(parseExpression());
+        }
+        match(Keyword::RIGHT_PAREN);
     }
+    return ast.add(NodeKind::CALL, offset, name, ast.endList(mark));
 }
 
-void Parser::parseTerm()
+// Precedence climbing sem recursao: operandos e operadores pendentes ficam em
+// pilhas no heap, entao a profundidade de parenteses e de cadeias de "not" so
+// e limitada pela memoria. Reproduz a gramatica
+//   expressao         -> expressao_simples [REL expressao_simples]
+//   expressao_simples -> [sinal] termo {ADD termo}
+//   termo             -> fator {MULT fator}
+//   fator             -> id | id ( lista_de_expressoes ) | numero | true | false | (expressao) | not fator
+// e constroi os nos na mesma ordem (pos-ordem) que a descida recursiva.
+NodeId Parser::parseExpression()
 {
-    parseFactor();
-    while (currentToken.getType() == TokenType::MULT_OPERATOR)
+    size_t operatorBase = operatorStack.size();
+    // Nivel atual ja tem um operador relacional, que nao e associativo
+    bool relationSeen = false;
+    // Sinal so pode abrir uma expressao simples
+    bool signAllowed = true;
+
+    for (;;)
     {
-        match(currentToken.getText());
-        parseFactor();
+        // Espera um operando: prefixos e parenteses sao empilhados ate chegar a um
+        Token token = currentToken;
+        switch (token.getType())
+        {
+        case TokenType::IDENTIFIER:
+            match(TokenType::IDENTIFIER);
+            if (currentToken.getKeyword() == Keyword::LEFT_PAREN)
+            {
+                match(Keyword::LEFT_PAREN);
+                operatorStack.push_back({PendingKind::CALL, Operator::NONE, 0, relationSeen, token.getOffset(), token.getSymbol(),
+                                         static_cast<uint32_t>(operandStack.size())});
+                relationSeen = false;
+                signAllowed = true;
+                continue;
+            }
+            operandStack.push_back(ast.add(NodeKind::IDENTIFIER, token.getOffset(), token.getSymbol()));
+            break;
+        case TokenType::NUMBER:
+            match(TokenType::NUMBER);
+            operandStack.push_back(ast.addInteger(token.getOffset(), token.getInteger()));
+            break;
+        case TokenType::FLOAT_NUMBER:
+            match(TokenType::FLOAT_NUMBER);
+            operandStack.push_back(ast.addReal(token.getOffset(), token.getReal()));
+            break;
+        case TokenType::ADD_OPERATOR:
+            if (signAllowed && token.getKeyword() != Keyword::OR)
+            {
+                match(TokenType::ADD_OPERATOR);
+                Operator sign = token.getText()[0] == '-' ? Operator::NEGATE : Operator::PLUS;
+                // O sinal vale para o termo inteiro: -a * b e -(a * b)
+                operatorStack.push_back({PendingKind::PREFIX, sign, ADDITIVE_PRECEDENCE, false, token.getOffset(), NO_SYMBOL, 0});
+                signAllowed = false;
+                continue;
+            }
+            error(SyntaxErrorCode::UNRECOGNIZED_FACTOR);
+            operandStack.push_back(NO_NODE);
+            break;
+        default:
+            switch (token.getKeyword())
+            {
+            case Keyword::LEFT_PAREN:
+                match(Keyword::LEFT_PAREN);
+                operatorStack.push_back({PendingKind::GROUP, Operator::NONE, 0, relationSeen, token.getOffset(), NO_SYMBOL, 0});
+                relationSeen = false;
+                signAllowed = true;
+                continue;
+            case Keyword::TRUE:
+            case Keyword::FALSE:
+                match(token.getKeyword());
+                operandStack.push_back(ast.add(NodeKind::BOOLEAN, token.getOffset(), token.getKeyword() == Keyword::TRUE));
+                break;
+            case Keyword::NOT:
+                match(Keyword::NOT);
+                operatorStack.push_back({PendingKind::PREFIX, Operator::NOT, NOT_PRECEDENCE, false, token.getOffset(), NO_SYMBOL, 0});
+                signAllowed = false;
+                continue;
+            default:
+                error(SyntaxErrorCode::UNRECOGNIZED_FACTOR);
+                operandStack.push_back(NO_NODE);
+                break;
+            }
+        }
+
+        // Tem um operando: fecha os parenteses que terminam aqui e para no
+        // proximo operador binario ou no fim da expressao
+        for (;;)
+        {
+            uint8_t precedence = binaryPrecedence(currentToken.getType());
+            if (precedence == RELATION_PRECEDENCE && relationSeen)
+            {
+                precedence = 0;
+            }
+            reduceOperators(operatorBase, precedence);
+            if (precedence != 0)
+            {
+                Token op = currentToken;
+                match(op.getType());
+                operatorStack.push_back({PendingKind::BINARY, classifyOperator(op), precedence, false, op.getOffset(), NO_SYMBOL, 0});
+                relationSeen = relationSeen || precedence == RELATION_PRECEDENCE;
+                signAllowed = precedence == RELATION_PRECEDENCE;
+                break;
+            }
+
+            if (operatorStack.size() == operatorBase)
+            {
+                NodeId result = operandStack.back();
+                operandStack.pop_back();
+                return result;
+            }
+
+            // Virgula dentro da chamada: o argumento fica na pilha e o proximo
+            // e uma expressao nova
+            if (operatorStack.back().kind == PendingKind::CALL && currentToken.getKeyword() == Keyword::COMMA)
+            {
+                match(Keyword::COMMA);
+                relationSeen = false;
+                signAllowed = true;
+                break;
+            }
+
+            PendingOperator group = operatorStack.back();
+            operatorStack.pop_back();
+            relationSeen = group.relationSeen;
+            if (group.kind == PendingKind::CALL)
+            {
+                size_t mark = ast.beginList();
+                for (size_t i = group.operandBase; i < operandStack.size(); i++)
+                {
+                    ast.pushItem(operandStack[i]);
+                }
+                uint32_t arguments = ast.endList(mark);
+                operandStack.resize(group.operandBase + 1);
+                match(Keyword::RIGHT_PAREN);
+                operandStack.back() = ast.add(NodeKind::CALL, group.offset, group.symbol, arguments);
+            }
+            else
+            {
+                match(Keyword::RIGHT_PAREN);
+            }
+        }
     }
 }
 
-void Parser::parseFactor()
+// Desempilha os operadores acima do parentese mais interno (ou de base) que
+// prendem seus operandos com forca maior ou igual a precedence
+void Parser::reduceOperators(size_t base, uint8_t precedence)
 {
-    if (currentToken.getType() == TokenType::IDENTIFIER)
+    while (operatorStack.size() > base)
     {
-        match(TokenType::IDENTIFIER);
-        if (currentToken.getText() == "(")
+        const PendingOperator &top = operatorStack.back();
+        if (top.kind == PendingKind::GROUP || top.kind == PendingKind::CALL || top.precedence < precedence)
         {
-            match("(");
-            parseExpression();
-            match(")");
+            return;
         }
+
+        if (top.kind == PendingKind::BINARY)
+        {
+            NodeId right = operandStack.back();
+            operandStack.pop_back();
+            operandStack.back() = ast.add(NodeKind::BINARY, top.offset, operandStack.back(), right, top.op);
+        }
+        else
+        {
+            operandStack.back() = ast.add(NodeKind::UNARY, top.offset, operandStack.back(), 0, top.op);
+        }
+        operatorStack.pop_back();
     }
-    else if (currentToken.getType() == TokenType::NUMBER || currentToken.getType() == TokenType::FLOAT_NUMBER)
-    {
-        match(currentToken.getType());
-    }
-    else if (currentToken.getText() == "(")
+}
+
+void Parser::dumpTrace(std::ostream &out) const
+{
+    trace.dump(out);
+}
+
+const std::vector<SyntaxDiagnostic> &Parser::getDiagnostics() const
+{
+    return diagnostics;
+}
+
+void Parser::setErrorLimit(size_t limit)
+{
+    if (limit == 0)
     {
-        match("(");
-        parseExpression();
-        match(")");
+        throw std::out_of_range("error limit must be at least 1");
     }
-    else if (currentToken.getText() == "not")
+    errorLimit = limit;
+}
+
+void Parser::setParallelParsing(size_t threshold, unsigned threads)
+{
+    parallelThreshold = threshold;
+    parallelThreads = threads;
+}
+
+__attribute__((cold, noinline)) void Parser::error(SyntaxErrorCode code, Keyword expectedKeyword, TokenType expectedType)
+{
+    report(code, expectedKeyword, expectedType);
+    synchronize();
+}
+
+__attribute__((cold)) void Parser::report(SyntaxErrorCode code, Keyword expectedKeyword, TokenType expectedType)
+{
+    if (panicking)
     {
-        match("not");
-        parseFactor();
+        return;
     }
-    else
+
+    diagnostics.push_back({currentToken.getOffset(), static_cast<uint32_t>(currentToken.getText().size()), code,
+                           expectedKeyword, expectedType, tokens.locate(currentToken.getOffset())});
+    panicking = true;
+    if (diagnostics.size() >= errorLimit)
     {
-        error("Unrecognized factor");
+        // Troca o token atual pelo fim da entrada: nenhum match volta a ter
+        // sucesso, panicking nao desliga e o parser so desempilha
+        currentToken = Token(TokenType::NONE, "", currentToken.getOffset());
     }
 }
 
-void Parser::error(const std::string &message)
+// Modo panico: descarta tokens ate um que possa seguir o trecho com erro
+void Parser::synchronize()
 {
-    // std::cerr << "Error: " << message << " at row " << scanner.getRow() << ", col " << scanner.getCol() << std::endl;
-    // exit(1);
-    std::cerr << "Error: " << message << std::endl;
-    exit(1);
+    while (currentToken.getType() != TokenType::NONE)
+    {
+        switch (currentToken.getKeyword())
+        {
+        case Keyword::SEMICOLON:
+        case Keyword::END:
+        case Keyword::ELSE:
+        case Keyword::THEN:
+        case Keyword::DO:
+        case Keyword::DOT:
+        case Keyword::BEGIN:
+        case Keyword::IF:
+        case Keyword::WHILE:
+            return;
+        default:
+            currentToken = tokens.next();
+        }
+    }
 }
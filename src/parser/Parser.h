@@ -1,34 +1,118 @@
 #ifndef PARSER_H
 #define PARSER_H
 
-#include "../lexical/Scanner/Scanner.h"
+#include <iosfwd>
+#include <vector>
+
+#include "../lexical/TokenBuffer/TokenBuffer.h"
+#include "ParserTrace.h"
+#include "Ast/Ast.h"
+#include "SyntaxDiagnostic.h"
 
 class Parser
 {
 public:
-    Parser(Scanner &scanner);
-    void parseProgram();
+    // A arvore e montada em ast, que pertence a quem chama e pode ser
+    // reaproveitada entre compilacoes com Ast::clear()
+    Parser(TokenCursor &tokens, Ast &ast);
+    // Erros sintaticos nao encerram o processo: cada um vira um
+    // SyntaxDiagnostic e a analise continua depois do proximo token de
+    // sincronizacao. Com erros, a arvore pode ter filhos NO_NODE.
+    NodeId parseProgram();
+    const std::vector<SyntaxDiagnostic> &getDiagnostics() const;
+    // Quantidade maxima de erros guardados, pelo menos 1 (0 lanca
+    // std::out_of_range); ao atingi-la o resto da entrada e ignorado
+    void setErrorLimit(size_t limit);
+    // Com o cursor sobre um TokenBuffer inteiro de pelo menos threshold
+    // tokens, parseProgram analisa os procedimentos do nivel mais externo em
+    // paralelo (0 = uma thread por nucleo); a arvore e os diagnosticos sao os
+    // mesmos da analise sequencial. SIZE_MAX desliga o modo paralelo.
+    void setParallelParsing(size_t threshold, unsigned threads = 0);
+    // Imprime o rastro guardado; nada no build sem -DPARSER_TRACE
+    void dumpTrace(std::ostream &out) const;
 
 private:
-    Scanner &scanner;
+    TokenLookahead tokens;
+    Ast &ast;
     Token currentToken;
+    ParserTraceSink trace;
+    std::vector<SyntaxDiagnostic> diagnostics;
+    size_t errorLimit = 25;
+    // Ligado entre um erro e o proximo match bem-sucedido; erros nesse
+    // intervalo sao consequencia do primeiro e nao sao reportados
+    bool panicking = false;
+
+    // Pilhas de parseExpression, reaproveitadas entre expressoes
+    enum class PendingKind : uint8_t
+    {
+        BINARY,
+        PREFIX,
+        GROUP, // "(" ainda aberto
+        CALL,  // "id(" ainda aberto
+    };
+    struct PendingOperator
+    {
+        PendingKind kind;
+        Operator op;
+        uint8_t precedence;
+        // GROUP/CALL: se o nivel de fora ja tinha um operador relacional
+        bool relationSeen;
+        uint32_t offset;
+        SymbolId symbol;
+        // CALL: tamanho da pilha de operandos na abertura; os argumentos ja
+        // lidos ficam acima dele
+        uint32_t operandBase;
+    };
+    std::vector<PendingOperator> operatorStack;
+    std::vector<NodeId> operandStack;
+
+    // Modo paralelo (ParallelParser.cpp): procedimentos ja analisados por
+    // outras threads, em ordem no fonte, cada um num trecho de uma das arenas
+    struct PreparedSubprogram
+    {
+        // Offset e indice do "procedure" e quantidade de tokens ate depois do ";"
+        uint32_t offset;
+        uint32_t token;
+        uint32_t tokenCount;
+        uint32_t arena;
+        AstRange range;
+    };
+    size_t parallelThreshold;
+    unsigned parallelThreads = 0;
+    std::vector<Ast> arenas;
+    std::vector<PreparedSubprogram> prepared;
+    size_t nextPrepared = 0;
 
-    void match(const std::string &expected);
+    // k-esimo token depois de currentToken, sem consumir; 1 <= k <= TokenLookahead::MAX_PEEK + 1
+    Token peek(size_t k) { return tokens.peek(k - 1); }
+    void match(Keyword expected);
     void match(TokenType expectedType);
-    void parseDeclarations();
+    // Devolvem o no construido ou, quando indicado, um indice de lista em Ast::extra
+    uint32_t parseDeclarations();
     void parseVariableDeclarations();
-    void parseIdentifierList();
-    void parseType();
-    void parseSubprogramDeclarations();
-    void parseCompoundCommand();
+    uint32_t parseIdentifierList();
+    Keyword parseType();
+    uint32_t parseSubprogramDeclarations();
+    NodeId parseSubprogram();
+    uint32_t parseArguments();
+    void prepareSubprograms(const TokenBuffer &buffer, unsigned threads);
+    // Copia para a arvore os procedimentos preparados que vem em sequencia a
+    // partir do token atual, poe cada um na lista aberta e pula os tokens
+    // deles; false se nenhum comeca no token atual
+    bool takePreparedSubprograms();
+    NodeId parseCompoundCommand();
+    bool startsCommand() const;
     void parseOptionalCommands();
     void parseCommandList();
-    void parseCommand();
-    void parseExpression();
-    void parseSimpleExpression();
-    void parseTerm();
-    void parseFactor();
-    void error(const std::string &message);
+    NodeId parseCommand();
+    NodeId parseProcedureActivation();
+    NodeId parseExpression();
+    void reduceOperators(size_t base, uint8_t precedence);
+    NodeId identifierNode();
+    void error(SyntaxErrorCode code, Keyword expectedKeyword = Keyword::NONE, TokenType expectedType = TokenType::NONE);
+    // Guarda o erro sem descartar tokens
+    void report(SyntaxErrorCode code, Keyword expectedKeyword = Keyword::NONE, TokenType expectedType = TokenType::NONE);
+    void synchronize();
 };
 
 #endif
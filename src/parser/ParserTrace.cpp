@@ -0,0 +1,56 @@
+#include "ParserTrace.h"
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+
+namespace
+{
+    template <size_t N>
+    void copyText(char (&field)[N], std::string_view text)
+    {
+        size_t length = std::min(text.size(), N);
+        std::memcpy(field, text.data(), length);
+        std::memset(field + length, 0, N - length);
+    }
+
+    template <size_t N>
+    std::string_view fieldText(const char (&field)[N])
+    {
+        return std::string_view(field, strnlen(field, N));
+    }
+}
+
+void RingTrace::record(TraceEvent event, std::string_view expected, TokenType expectedType, const Token &current)
+{
+    TraceRecord &slot = records[count++ % CAPACITY];
+    slot.event = event;
+    slot.expectedType = static_cast<uint8_t>(expectedType);
+    slot.actualType = static_cast<uint8_t>(current.getType());
+    slot.offset = current.getOffset();
+    copyText(slot.expected, expected);
+    copyText(slot.actual, current.getText());
+}
+
+void RingTrace::dump(std::ostream &out) const
+{
+    size_t first = count > CAPACITY ? count - CAPACITY : 0;
+    out << "Parser trace (" << count - first << " of " << count << " events):\n";
+    for (size_t i = first; i < count; i++)
+    {
+        const TraceRecord &slot = records[i % CAPACITY];
+        out << "  @" << slot.offset << " ";
+        switch (slot.event)
+        {
+        case TraceEvent::ENTER:
+            out << "Entering " << fieldText(slot.expected);
+            break;
+        case TraceEvent::MATCH_TEXT:
+            out << "Matching: |" << fieldText(slot.expected) << "|";
+            break;
+        case TraceEvent::MATCH_TYPE:
+            out << "Expected Token Type: " << static_cast<int>(slot.expectedType);
+            break;
+        }
+        out << " with |" << fieldText(slot.actual) << "| (Type: " << static_cast<int>(slot.actualType) << ")\n";
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef PARSER_TRACE_H
+#define PARSER_TRACE_H
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+#include "../lexical/Token/Token.h"
+
+// Rastro do Parser, escolhido em tempo de compilacao. No build normal o
+// Parser usa NullTrace, cujos metodos vazios somem na compilacao. Com
+// -DPARSER_TRACE usa RingTrace, que guarda os ultimos eventos em memoria, sem
+// E/S, e so os imprime no erro ou quando pedido (Parser::dumpTrace).
+
+enum class TraceEvent : uint8_t
+{
+    ENTER,
+    MATCH_TEXT,
+    MATCH_TYPE,
+};
+
+// Registro de tamanho fixo; textos maiores que os campos sao truncados
+struct TraceRecord
+{
+    TraceEvent event;
+    uint8_t expectedType;
+    uint8_t actualType;
+    uint32_t offset;
+    char expected[12];
+    char actual[12];
+};
+
+class NullTrace
+{
+public:
+    void enter(std::string_view, const Token &) {}
+    void matchText(std::string_view, const Token &) {}
+    void matchType(TokenType, const Token &) {}
+    void dump(std::ostream &) const {}
+};
+
+class RingTrace
+{
+public:
+    static constexpr size_t CAPACITY = 1024;
+
+    void enter(std::string_view rule, const Token &current)
+    {
+        record(TraceEvent::ENTER, rule, TokenType::NONE, current);
+    }
+    void matchText(std::string_view expected, const Token &current)
+    {
+        record(TraceEvent::MATCH_TEXT, expected, TokenType::NONE, current);
+    }
+    void matchType(TokenType expected, const Token &current)
+    {
+        record(TraceEvent::MATCH_TYPE, {}, expected, current);
+    }
+    // Do registro mais antigo ainda no anel ao mais recente
+    void dump(std::ostream &out) const;
+
+private:
+    std::array<TraceRecord, CAPACITY> records;
+    size_t count = 0;
+
+    void record(TraceEvent event, std::string_view expected, TokenType expectedType, const Token &current);
+};
+
+#ifdef PARSER_TRACE
+using ParserTraceSink = RingTrace;
+#else
+using ParserTraceSink = NullTrace;
+#endif
+
+#endif
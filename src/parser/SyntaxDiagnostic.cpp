@@ -0,0 +1,23 @@
+#include "SyntaxDiagnostic.h"
+
+std::string formatSyntaxDiagnostic(const SyntaxDiagnostic &diagnostic)
+{
+    switch (diagnostic.code)
+    {
+    case SyntaxErrorCode::EXPECTED_PROGRAM:
+        return "Expected 'program'";
+    case SyntaxErrorCode::EXPECTED_KEYWORD:
+        return "Expected '" + std::string(keywordText(diagnostic.expectedKeyword)) + "'";
+    case SyntaxErrorCode::UNEXPECTED_TOKEN_TYPE:
+        return "Unexpected token type";
+    case SyntaxErrorCode::EXPECTED_TYPE:
+        return "Expected type";
+    case SyntaxErrorCode::UNRECOGNIZED_COMMAND:
+        return "Unrecognized command";
+    case SyntaxErrorCode::UNRECOGNIZED_FACTOR:
+        return "Unrecognized factor";
+    case SyntaxErrorCode::UNEXPECTED_TOKEN:
+        return "Unexpected token";
+    }
+    return "Syntax error";
+}
@@ -0,0 +1,43 @@
+#ifndef SYNTAX_DIAGNOSTIC_H
+#define SYNTAX_DIAGNOSTIC_H
+
+#include <cstdint>
+#include <string>
+
+#include "../lexical/Source/LineIndex.h"
+#include "../lexical/Token/Token.h"
+
+enum class SyntaxErrorCode : uint8_t
+{
+    EXPECTED_PROGRAM,
+    EXPECTED_KEYWORD,
+    UNEXPECTED_TOKEN_TYPE,
+    EXPECTED_TYPE,
+    UNRECOGNIZED_COMMAND,
+    UNRECOGNIZED_FACTOR,
+    // Token sem producao na tabela LL(1)
+    UNEXPECTED_TOKEN,
+};
+
+// Erro sintatico em forma compacta, no estilo do Diagnostic lexico: o token
+// rejeitado, source[offset, offset + length), e o que era esperado. A
+// mensagem so e montada em formatSyntaxDiagnostic.
+struct SyntaxDiagnostic
+{
+    uint32_t offset;
+    uint32_t length;
+    SyntaxErrorCode code;
+    // Palavra-chave ou pontuacao esperada em EXPECTED_KEYWORD
+    Keyword expectedKeyword;
+    // Tipo esperado em UNEXPECTED_TOKEN_TYPE
+    TokenType expectedType;
+    // Linha e coluna lidas do TokenSource no momento do erro, enquanto o
+    // token ainda esta na janela (entrada em streaming); row 0 nos demais
+    // casos, em que quem imprime localiza o offset depois
+    SourceLocation location;
+};
+
+// Mensagem sem posicao, igual a que o Parser imprimia antes da recuperacao
+std::string formatSyntaxDiagnostic(const SyntaxDiagnostic &diagnostic);
+
+#endif
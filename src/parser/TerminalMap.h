@@ -0,0 +1,88 @@
+#ifndef TERMINAL_MAP_H
+#define TERMINAL_MAP_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "../lexical/Token/Token.h"
+
+// Terminal de uma tabela gerada (LL(1) ou LALR(1)) para cada token, pelos
+// nomes que getGramatica() usa: palavras-chave (true e false inclusive) e
+// pontuacao pela Keyword, operadores pelo texto e id, num_int e num_real pela
+// categoria do token. O que nao aparece na gramatica vira unknown.
+struct TerminalMap
+{
+    using Symbol = int16_t;
+
+    // Operadores sem Keyword (+, -, *, /, =, <, ...), procurados pelo texto
+    struct OperatorTerminal
+    {
+        std::string_view text;
+        Symbol terminal = 0;
+    };
+    static constexpr std::array<std::string_view, 10> OPERATORS = {"+", "-", "*", "/", "=", "<", ">", "<=", ">=", "<>"};
+    static constexpr size_t KEYWORDS = static_cast<size_t>(Keyword::ASSIGN) + 1;
+
+    Symbol end = 0;
+    Symbol unknown = 0;
+    Symbol identifier = 0;
+    Symbol integerLiteral = 0;
+    Symbol realLiteral = 0;
+    std::array<Symbol, KEYWORDS> keywordTerminals{};
+    std::array<OperatorTerminal, OPERATORS.size()> operatorTerminals{};
+
+    // lookup(nome) devolve o terminal com esse nome, ou unknown
+    template <typename Lookup>
+    static constexpr TerminalMap fromNames(Symbol end, Symbol unknown, Lookup lookup)
+    {
+        TerminalMap map;
+        map.end = end;
+        map.unknown = unknown;
+        map.keywordTerminals[0] = unknown;
+        for (size_t k = 1; k < KEYWORDS; k++)
+        {
+            map.keywordTerminals[k] = lookup(keywordText(static_cast<Keyword>(k)));
+        }
+        map.identifier = lookup("id");
+        map.integerLiteral = lookup("num_int");
+        map.realLiteral = lookup("num_real");
+        for (size_t i = 0; i < OPERATORS.size(); i++)
+        {
+            map.operatorTerminals[i] = {OPERATORS[i], lookup(OPERATORS[i])};
+        }
+        return map;
+    }
+
+    Symbol terminalOf(const Token &token) const
+    {
+        Keyword keyword = token.getKeyword();
+        if (keyword != Keyword::NONE)
+        {
+            return keywordTerminals[static_cast<size_t>(keyword)];
+        }
+
+        switch (token.getType())
+        {
+        case TokenType::IDENTIFIER:
+            return identifier;
+        case TokenType::NUMBER:
+            return integerLiteral;
+        case TokenType::FLOAT_NUMBER:
+            return realLiteral;
+        case TokenType::NONE:
+            return end;
+        default:
+            for (const OperatorTerminal &op : operatorTerminals)
+            {
+                if (token.getText() == op.text)
+                {
+                    return op.terminal;
+                }
+            }
+            return unknown;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,730 @@
+#include "Grammar.h"
+#include <algorithm>
+
+TerminalSets::TerminalSets(size_t rows, size_t columns) : words((columns + 63) / 64), bits(rows * words, 0) {}
+
+bool TerminalSets::insert(size_t row, size_t column)
+{
+    uint64_t &word = bits[row * words + column / 64];
+    uint64_t mask = uint64_t(1) << (column % 64);
+    bool added = (word & mask) == 0;
+    word |= mask;
+    return added;
+}
+
+bool TerminalSets::merge(size_t row, const uint64_t *from)
+{
+    uint64_t *to = bits.data() + row * words;
+    uint64_t changed = 0;
+    for (size_t i = 0; i < words; i++)
+    {
+        uint64_t merged = to[i] | from[i];
+        changed |= merged ^ to[i];
+        to[i] = merged;
+    }
+    return changed != 0;
+}
+
+Grammar Grammar::fromRules(const Gramatica &rules, const std::string &start)
+{
+    Grammar grammar;
+    grammar.end = grammar.intern("$", false);
+    for (const auto &[naoTerminal, regras] : rules)
+    {
+        grammar.intern(naoTerminal, true);
+    }
+
+    Rules editable;
+    for (const auto &[naoTerminal, regras] : rules)
+    {
+        std::vector<Body> alternatives;
+        for (const std::string &regra : regras)
+        {
+            Body body;
+            for (const std::string &simbolo : simbolosDaRegra(regra))
+            {
+                body.push_back(grammar.intern(simbolo, rules.count(simbolo) != 0));
+            }
+            alternatives.push_back(std::move(body));
+        }
+        editable.emplace_back(grammar.ids[naoTerminal], std::move(alternatives));
+    }
+
+    auto found = grammar.ids.find(start);
+    if (found != grammar.ids.end() && grammar.isNonterminal(found->second))
+    {
+        grammar.start = found->second;
+    }
+    grammar.pack(editable);
+    return grammar;
+}
+
+Gramatica Grammar::toRules() const
+{
+    Gramatica rules;
+    for (Symbol nonterminal : nonterminalList)
+    {
+        Regras &regras = rules[names[nonterminal]];
+        auto [first, last] = productionsOf(nonterminal);
+        for (uint32_t production = first; production < last; production++)
+        {
+            std::string regra;
+            for (const Symbol *symbol = bodyBegin(production); symbol != bodyEnd(production); symbol++)
+            {
+                regra += regra.empty() ? names[*symbol] : " " + names[*symbol];
+            }
+            regras.push_back(regra);
+        }
+    }
+    return rules;
+}
+
+std::pair<uint32_t, uint32_t> Grammar::productionsOf(Symbol nonterminal) const
+{
+    uint32_t index = ordinals[nonterminal];
+    return {firstProduction[index], firstProduction[index + 1]};
+}
+
+Grammar::Symbol Grammar::intern(const std::string &name, bool nonterminal)
+{
+    auto [it, inserted] = ids.emplace(name, static_cast<Symbol>(names.size()));
+    if (inserted)
+    {
+        names.push_back(name);
+        nonterminalFlags.push_back(nonterminal ? 1 : 0);
+    }
+    return it->second;
+}
+
+Grammar::Symbol Grammar::freshNonterminal(Symbol base)
+{
+    std::string name = names[base] + "'";
+    while (ids.count(name))
+    {
+        name += "'";
+    }
+    return intern(name, true);
+}
+
+Grammar::Rules Grammar::unpack() const
+{
+    Rules rules;
+    rules.reserve(nonterminalList.size());
+    for (Symbol nonterminal : nonterminalList)
+    {
+        std::vector<Body> alternatives;
+        auto [first, last] = productionsOf(nonterminal);
+        for (uint32_t production = first; production < last; production++)
+        {
+            alternatives.emplace_back(bodyBegin(production), bodyEnd(production));
+        }
+        rules.emplace_back(nonterminal, std::move(alternatives));
+    }
+    return rules;
+}
+
+void Grammar::pack(const Rules &rules)
+{
+    productionLhs.clear();
+    bodyStart.assign(1, 0);
+    bodies.clear();
+    firstProduction.clear();
+    nonterminalList.clear();
+    terminalList.assign(1, end);
+    ordinals.assign(names.size(), INVALID);
+    ordinals[end] = 0;
+
+    for (const auto &[nonterminal, alternatives] : rules)
+    {
+        ordinals[nonterminal] = static_cast<uint32_t>(nonterminalList.size());
+        nonterminalList.push_back(nonterminal);
+        firstProduction.push_back(static_cast<uint32_t>(productionLhs.size()));
+        for (const Body &body : alternatives)
+        {
+            productionLhs.push_back(nonterminal);
+            bodies.insert(bodies.end(), body.begin(), body.end());
+            bodyStart.push_back(static_cast<uint32_t>(bodies.size()));
+            for (Symbol symbol : body)
+            {
+                if (!isNonterminal(symbol) && ordinals[symbol] == INVALID)
+                {
+                    ordinals[symbol] = static_cast<uint32_t>(terminalList.size());
+                    terminalList.push_back(symbol);
+                }
+            }
+        }
+    }
+    firstProduction.push_back(static_cast<uint32_t>(productionLhs.size()));
+}
+
+namespace
+{
+    // Componentes fortemente conexos (Tarjan, sem recursao) de um grafo dado
+    // por listas de adjacencia
+    std::vector<uint32_t> stronglyConnected(const std::vector<std::vector<uint32_t>> &edges)
+    {
+        const uint32_t unvisited = UINT32_MAX;
+        size_t n = edges.size();
+        std::vector<uint32_t> index(n, unvisited), low(n, 0), component(n, unvisited);
+        std::vector<uint8_t> onStack(n, 0);
+        std::vector<uint32_t> stack;
+        std::vector<std::pair<uint32_t, size_t>> calls;
+        uint32_t counter = 0;
+        uint32_t components = 0;
+
+        for (uint32_t root = 0; root < n; root++)
+        {
+            if (index[root] != unvisited)
+            {
+                continue;
+            }
+            calls.emplace_back(root, 0);
+            while (!calls.empty())
+            {
+                auto &[node, next] = calls.back();
+                if (next == 0 && index[node] == unvisited)
+                {
+                    index[node] = low[node] = counter++;
+                    stack.push_back(node);
+                    onStack[node] = 1;
+                }
+                if (next < edges[node].size())
+                {
+                    uint32_t target = edges[node][next++];
+                    if (index[target] == unvisited)
+                    {
+                        calls.emplace_back(target, 0);
+                    }
+                    else if (onStack[target])
+                    {
+                        low[node] = std::min(low[node], index[target]);
+                    }
+                    continue;
+                }
+
+                uint32_t finished = node;
+                calls.pop_back();
+                if (low[finished] == index[finished])
+                {
+                    uint32_t member;
+                    do
+                    {
+                        member = stack.back();
+                        stack.pop_back();
+                        onStack[member] = 0;
+                        component[member] = components;
+                    } while (member != finished);
+                    components++;
+                }
+                if (!calls.empty())
+                {
+                    uint32_t parent = calls.back().first;
+                    low[parent] = std::min(low[parent], low[finished]);
+                }
+            }
+        }
+        return component;
+    }
+}
+
+void Grammar::removeLeftRecursion()
+{
+    Rules rules = unpack();
+    size_t n = rules.size();
+
+    // Grafo de cantos a esquerda: A -> B quando alguma regra de A comeca com B.
+    // So os nao-terminais de um mesmo ciclo precisam ser substituidos uns nos
+    // outros; os demais ficam como estao. Recursao escondida atras de um
+    // prefixo anulavel nao e tratada.
+    std::vector<std::vector<uint32_t>> edges(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (const Body &body : rules[i].second)
+        {
+            if (!body.empty() && isNonterminal(body[0]))
+            {
+                edges[i].push_back(ordinals[body[0]]);
+            }
+        }
+    }
+    std::vector<uint32_t> component = stronglyConnected(edges);
+    std::vector<std::vector<uint32_t>> members(n);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        members[component[i]].push_back(i);
+    }
+
+    std::vector<std::vector<std::pair<Symbol, std::vector<Body>>>> added(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        Symbol nonterminal = rules[i].first;
+        std::vector<Body> &alternatives = rules[i].second;
+
+        // Ai -> Aj γ, com j < i no mesmo ciclo, vira Ai -> δ γ para cada Aj -> δ
+        for (uint32_t j : members[component[i]])
+        {
+            if (j >= i)
+            {
+                break;
+            }
+            Symbol earlier = rules[j].first;
+            std::vector<Body> substituted;
+            for (const Body &body : alternatives)
+            {
+                if (body.empty() || body[0] != earlier)
+                {
+                    substituted.push_back(body);
+                    continue;
+                }
+                for (const Body &delta : rules[j].second)
+                {
+                    Body expanded = delta;
+                    expanded.insert(expanded.end(), body.begin() + 1, body.end());
+                    substituted.push_back(std::move(expanded));
+                }
+            }
+            alternatives = std::move(substituted);
+        }
+
+        // Recursao direta: A -> A α | β vira A -> β A', A' -> α A' | ε
+        bool recursive = false;
+        for (const Body &body : alternatives)
+        {
+            recursive = recursive || (!body.empty() && body[0] == nonterminal);
+        }
+        if (!recursive)
+        {
+            continue;
+        }
+
+        Symbol fresh = freshNonterminal(nonterminal);
+        std::vector<Body> base;
+        std::vector<Body> tails;
+        for (const Body &body : alternatives)
+        {
+            if (!body.empty() && body[0] == nonterminal)
+            {
+                // A -> A nao acrescenta nada
+                if (body.size() > 1)
+                {
+                    Body tail(body.begin() + 1, body.end());
+                    tail.push_back(fresh);
+                    tails.push_back(std::move(tail));
+                }
+            }
+            else
+            {
+                Body head = body;
+                head.push_back(fresh);
+                base.push_back(std::move(head));
+            }
+        }
+        tails.emplace_back();
+        alternatives = std::move(base);
+        added[i].emplace_back(fresh, std::move(tails));
+    }
+
+    Rules result;
+    for (size_t i = 0; i < n; i++)
+    {
+        result.push_back(std::move(rules[i]));
+        for (auto &rule : added[i])
+        {
+            result.push_back(std::move(rule));
+        }
+    }
+    pack(result);
+}
+
+void Grammar::leftFactor()
+{
+    Rules work = unpack();
+    // Marca dos primeiros simbolos ja vistos: seen[s] == stamp vale "visto
+    // nesta passada", sem limpar o vetor a cada nao-terminal
+    std::vector<uint32_t> seen(names.size(), 0);
+    uint32_t stamp = 0;
+    // work cresce com os nao-terminais novos, que tambem sao fatorados
+    for (size_t i = 0; i < work.size(); i++)
+    {
+        for (;;)
+        {
+            const std::vector<Body> &alternatives = work[i].second;
+
+            // Primeiro simbolo repetido, na ordem de aparicao
+            stamp++;
+            Symbol shared = INVALID;
+            for (const Body &body : alternatives)
+            {
+                if (body.empty())
+                {
+                    continue;
+                }
+                if (seen[body[0]] == stamp)
+                {
+                    shared = body[0];
+                    break;
+                }
+                seen[body[0]] = stamp;
+            }
+            if (shared == INVALID)
+            {
+                break;
+            }
+
+            // Maior prefixo comum do grupo
+            const Body *model = nullptr;
+            size_t prefix = 0;
+            for (const Body &body : alternatives)
+            {
+                if (body.empty() || body[0] != shared)
+                {
+                    continue;
+                }
+                if (model == nullptr)
+                {
+                    model = &body;
+                    prefix = body.size();
+                    continue;
+                }
+                size_t k = 0;
+                while (k < prefix && k < body.size() && body[k] == (*model)[k])
+                {
+                    k++;
+                }
+                prefix = k;
+            }
+
+            Symbol fresh = freshNonterminal(work[i].first);
+            seen.push_back(0);
+            Body head(model->begin(), model->begin() + prefix);
+            head.push_back(fresh);
+            std::vector<Body> factored;
+            std::vector<Body> suffixes;
+            bool placed = false;
+            for (const Body &body : alternatives)
+            {
+                if (body.empty() || body[0] != shared)
+                {
+                    factored.push_back(body);
+                    continue;
+                }
+                if (!placed)
+                {
+                    factored.push_back(head);
+                    placed = true;
+                }
+                Body suffix(body.begin() + prefix, body.end());
+                if (std::find(suffixes.begin(), suffixes.end(), suffix) == suffixes.end())
+                {
+                    suffixes.push_back(std::move(suffix));
+                }
+            }
+            work[i].second = std::move(factored);
+            work.emplace_back(fresh, std::move(suffixes));
+        }
+    }
+    pack(work);
+}
+
+void Grammar::removeUnreachable()
+{
+    if (start == INVALID)
+    {
+        return;
+    }
+
+    std::vector<uint8_t> reachable(names.size(), 0);
+    std::vector<Symbol> pending = {start};
+    reachable[start] = 1;
+    while (!pending.empty())
+    {
+        Symbol current = pending.back();
+        pending.pop_back();
+        auto [first, last] = productionsOf(current);
+        for (uint32_t production = first; production < last; production++)
+        {
+            for (const Symbol *symbol = bodyBegin(production); symbol != bodyEnd(production); symbol++)
+            {
+                if (isNonterminal(*symbol) && !reachable[*symbol])
+                {
+                    reachable[*symbol] = 1;
+                    pending.push_back(*symbol);
+                }
+            }
+        }
+    }
+
+    Rules rules = unpack();
+    rules.erase(std::remove_if(rules.begin(), rules.end(), [&reachable](const auto &rule) { return !reachable[rule.first]; }),
+                rules.end());
+    pack(rules);
+}
+
+bool Grammar::expandConflictingPrefixes()
+{
+    Analysis analysis = analyze();
+    size_t words = analysis.first.wordsPerRow();
+    Rules rules = unpack();
+
+    // Uma expansao por chamada, visitando os nao-terminais pelo nome, como
+    // fazia a versao em texto sobre o map: cada rodada muda pouco e o
+    // resultado nao depende da ordem interna das regras
+    std::vector<size_t> order(rules.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(),
+              [this, &rules](size_t a, size_t b) { return names[rules[a].first] < names[rules[b].first]; });
+
+    std::vector<uint64_t> firsts;
+    for (size_t index : order)
+    {
+        Symbol nonterminal = rules[index].first;
+        std::vector<Body> &alternatives = rules[index].second;
+
+        // FIRST de cada alternativa, uma linha de bits por alternativa
+        firsts.assign(alternatives.size() * words, 0);
+        for (size_t i = 0; i < alternatives.size(); i++)
+        {
+            firstOfSequence(analysis, alternatives[i].data(), alternatives[i].data() + alternatives[i].size(),
+                            firsts.data() + i * words);
+        }
+
+        for (size_t i = 0; i < alternatives.size(); i++)
+        {
+            for (size_t j = i + 1; j < alternatives.size(); j++)
+            {
+                const Body &a = alternatives[i];
+                const Body &b = alternatives[j];
+                if (a.empty() || b.empty() || a[0] == b[0])
+                {
+                    continue;
+                }
+                uint64_t overlap = 0;
+                for (size_t w = 0; w < words; w++)
+                {
+                    overlap |= firsts[i * words + w] & firsts[j * words + w];
+                }
+                if (overlap == 0)
+                {
+                    continue;
+                }
+
+                // Expande a alternativa que comeca com nao-terminal
+                size_t target = isNonterminal(a[0]) ? i : j;
+                Body body = alternatives[target];
+                if (!isNonterminal(body[0]) || body[0] == nonterminal)
+                {
+                    continue;
+                }
+                std::vector<Body> expanded;
+                auto [first, last] = productionsOf(body[0]);
+                for (uint32_t production = first; production < last; production++)
+                {
+                    Body replacement(bodyBegin(production), bodyEnd(production));
+                    replacement.insert(replacement.end(), body.begin() + 1, body.end());
+                    expanded.push_back(std::move(replacement));
+                }
+                alternatives.erase(alternatives.begin() + target);
+                alternatives.insert(alternatives.begin() + target, expanded.begin(), expanded.end());
+                pack(rules);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void Grammar::prepareForLL1()
+{
+    removeLeftRecursion();
+    leftFactor();
+    // Limite de rodadas: uma gramatica que nao e LL(1) de jeito nenhum para
+    // aqui e os conflitos restantes aparecem na tabela
+    for (int round = 0; round < 16 && expandConflictingPrefixes(); round++)
+    {
+        leftFactor();
+    }
+    removeUnreachable();
+}
+
+Grammar::Analysis Grammar::analyze() const
+{
+    size_t terminalCount = terminalList.size();
+    size_t nonterminalCount = nonterminalList.size();
+    size_t productions = productionCount();
+    Analysis analysis{std::vector<uint8_t>(nonterminalCount, 0), TerminalSets(nonterminalCount, terminalCount),
+                      TerminalSets(nonterminalCount, terminalCount)};
+    std::vector<uint32_t> worklist;
+    std::vector<uint8_t> queued(nonterminalCount, 0);
+
+    // Anulaveis: cada producao conta os simbolos do corpo ainda nao anulaveis;
+    // quando a conta zera, o lado esquerdo e anulavel
+    std::vector<uint32_t> remaining(productions, 0);
+    std::vector<std::vector<uint32_t>> occurrences(nonterminalCount);
+    for (uint32_t production = 0; production < productions; production++)
+    {
+        uint32_t count = 0;
+        for (const Symbol *symbol = bodyBegin(production); symbol != bodyEnd(production); symbol++)
+        {
+            count++;
+            if (isNonterminal(*symbol))
+            {
+                occurrences[ordinals[*symbol]].push_back(production);
+            }
+            else
+            {
+                // Terminal nunca some: a conta jamais chega a zero
+                count++;
+            }
+        }
+        remaining[production] = count;
+        uint32_t lhsIndex = ordinals[productionLhs[production]];
+        if (count == 0 && !analysis.nullable[lhsIndex])
+        {
+            analysis.nullable[lhsIndex] = 1;
+            worklist.push_back(lhsIndex);
+        }
+    }
+    while (!worklist.empty())
+    {
+        uint32_t symbol = worklist.back();
+        worklist.pop_back();
+        for (uint32_t production : occurrences[symbol])
+        {
+            uint32_t lhsIndex = ordinals[productionLhs[production]];
+            if (--remaining[production] == 0 && !analysis.nullable[lhsIndex])
+            {
+                analysis.nullable[lhsIndex] = 1;
+                worklist.push_back(lhsIndex);
+            }
+        }
+    }
+
+    auto propagate = [&](TerminalSets &sets, const std::vector<std::vector<uint32_t>> &dependents) {
+        worklist.clear();
+        for (uint32_t i = 0; i < nonterminalCount; i++)
+        {
+            worklist.push_back(i);
+            queued[i] = 1;
+        }
+        while (!worklist.empty())
+        {
+            uint32_t source = worklist.back();
+            worklist.pop_back();
+            queued[source] = 0;
+            for (uint32_t target : dependents[source])
+            {
+                if (sets.merge(target, sets.row(source)) && !queued[target])
+                {
+                    queued[target] = 1;
+                    worklist.push_back(target);
+                }
+            }
+        }
+    };
+
+    // FIRST: terminais iniciais direto; FIRST(A) ⊇ FIRST(B) para cada B no
+    // prefixo anulavel de uma regra de A
+    std::vector<std::vector<uint32_t>> dependents(nonterminalCount);
+    for (uint32_t production = 0; production < productions; production++)
+    {
+        uint32_t lhsIndex = ordinals[productionLhs[production]];
+        for (const Symbol *symbol = bodyBegin(production); symbol != bodyEnd(production); symbol++)
+        {
+            if (!isNonterminal(*symbol))
+            {
+                analysis.first.insert(lhsIndex, ordinals[*symbol]);
+                break;
+            }
+            uint32_t index = ordinals[*symbol];
+            if (index != lhsIndex)
+            {
+                dependents[index].push_back(lhsIndex);
+            }
+            if (!analysis.nullable[index])
+            {
+                break;
+            }
+        }
+    }
+    propagate(analysis.first, dependents);
+
+    // FOLLOW: para A -> α B β, FIRST(β) entra direto em FOLLOW(B) e, se β
+    // e anulavel, FOLLOW(B) ⊇ FOLLOW(A)
+    for (auto &list : dependents)
+    {
+        list.clear();
+    }
+    if (start != INVALID)
+    {
+        analysis.follow.insert(ordinals[start], 0);
+    }
+    size_t words = analysis.first.wordsPerRow();
+    std::vector<uint64_t> suffix(words);
+    for (uint32_t production = 0; production < productions; production++)
+    {
+        uint32_t lhsIndex = ordinals[productionLhs[production]];
+        std::fill(suffix.begin(), suffix.end(), 0);
+        bool suffixNullable = true;
+        for (const Symbol *symbol = bodyEnd(production); symbol != bodyBegin(production);)
+        {
+            --symbol;
+            uint32_t index = ordinals[*symbol];
+            if (!isNonterminal(*symbol))
+            {
+                std::fill(suffix.begin(), suffix.end(), 0);
+                suffix[index / 64] |= uint64_t(1) << (index % 64);
+                suffixNullable = false;
+                continue;
+            }
+
+            analysis.follow.merge(index, suffix.data());
+            if (suffixNullable && index != lhsIndex)
+            {
+                dependents[lhsIndex].push_back(index);
+            }
+            const uint64_t *first = analysis.first.row(index);
+            if (analysis.nullable[index])
+            {
+                for (size_t w = 0; w < words; w++)
+                {
+                    suffix[w] |= first[w];
+                }
+            }
+            else
+            {
+                std::copy(first, first + words, suffix.begin());
+                suffixNullable = false;
+            }
+        }
+    }
+    propagate(analysis.follow, dependents);
+
+    return analysis;
+}
+
+bool Grammar::firstOfSequence(const Analysis &analysis, const Symbol *begin, const Symbol *end, uint64_t *out) const
+{
+    size_t words = analysis.first.wordsPerRow();
+    for (const Symbol *symbol = begin; symbol != end; symbol++)
+    {
+        uint32_t index = ordinals[*symbol];
+        if (!isNonterminal(*symbol))
+        {
+            out[index / 64] |= uint64_t(1) << (index % 64);
+            return false;
+        }
+        const uint64_t *first = analysis.first.row(index);
+        for (size_t w = 0; w < words; w++)
+        {
+            out[w] |= first[w];
+        }
+        if (!analysis.nullable[index])
+        {
+            return false;
+        }
+    }
+    return true;
+}
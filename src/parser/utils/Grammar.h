@@ -0,0 +1,119 @@
+#ifndef GRAMMAR_H
+#define GRAMMAR_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "operacoesGramatica.h"
+
+// Conjuntos de terminais em bits, uma linha por nao-terminal
+class TerminalSets
+{
+public:
+    TerminalSets() = default;
+    TerminalSets(size_t rows, size_t columns);
+
+    bool contains(size_t row, size_t column) const
+    {
+        return (bits[row * words + column / 64] >> (column % 64)) & 1;
+    }
+    // true se o bit era novo
+    bool insert(size_t row, size_t column);
+    // Uniao com uma linha de mesma largura; true se algo mudou
+    bool merge(size_t row, const uint64_t *from);
+    const uint64_t *row(size_t index) const { return bits.data() + index * words; }
+    size_t wordsPerRow() const { return words; }
+
+private:
+    size_t words = 0;
+    std::vector<uint64_t> bits;
+};
+
+// Gramatica com simbolos internados. Terminais e nao-terminais dividem o
+// espaco de Symbol; as producoes ficam agrupadas por lado esquerdo e os
+// corpos num vetor plano. As transformacoes reescrevem a gramatica inteira
+// em O(tamanho), e a analise (anulaveis, FIRST, FOLLOW) e feita em bits por
+// ponto fixo com lista de trabalho.
+class Grammar
+{
+public:
+    using Symbol = uint32_t;
+    static constexpr Symbol INVALID = UINT32_MAX;
+
+    // Regras no formato de getGramatica(). Sem inicial nao ha FOLLOW nem
+    // remocao de inalcancaveis.
+    static Grammar fromRules(const Gramatica &rules, const std::string &start = "");
+    Gramatica toRules() const;
+
+    size_t symbolCount() const { return names.size(); }
+    const std::string &name(Symbol symbol) const { return names[symbol]; }
+    bool isNonterminal(Symbol symbol) const { return nonterminalFlags[symbol] != 0; }
+    Symbol startSymbol() const { return start; }
+    // Terminal "$", sempre o de ordinal 0
+    Symbol endMarker() const { return end; }
+
+    // Ordinais densos usados pelos conjuntos: posicao em terminals() para
+    // terminais, em nonterminals() para nao-terminais
+    const std::vector<Symbol> &terminals() const { return terminalList; }
+    const std::vector<Symbol> &nonterminals() const { return nonterminalList; }
+    uint32_t ordinal(Symbol symbol) const { return ordinals[symbol]; }
+
+    size_t productionCount() const { return productionLhs.size(); }
+    Symbol lhs(uint32_t production) const { return productionLhs[production]; }
+    const Symbol *bodyBegin(uint32_t production) const { return bodies.data() + bodyStart[production]; }
+    const Symbol *bodyEnd(uint32_t production) const { return bodies.data() + bodyStart[production + 1]; }
+    // Producoes do nao-terminal: [first, second)
+    std::pair<uint32_t, uint32_t> productionsOf(Symbol nonterminal) const;
+
+    // Recursao a esquerda direta e indireta (so nos ciclos de cantos a esquerda)
+    void removeLeftRecursion();
+    void leftFactor();
+    void removeUnreachable();
+    // Troca o nao-terminal que abre uma alternativa quando ela disputa
+    // terminais com uma irma de outro prefixo, uma por chamada; true se trocou
+    bool expandConflictingPrefixes();
+    // Recursao, fatoracao e expansoes ate a gramatica estabilizar
+    void prepareForLL1();
+
+    struct Analysis
+    {
+        std::vector<uint8_t> nullable; // por ordinal de nao-terminal
+        TerminalSets first;
+        TerminalSets follow;
+    };
+    Analysis analyze() const;
+    // FIRST de [begin, end) somado a out (uma linha de TerminalSets); true se anulavel
+    bool firstOfSequence(const Analysis &analysis, const Symbol *begin, const Symbol *end, uint64_t *out) const;
+
+private:
+    std::vector<std::string> names;
+    std::vector<uint8_t> nonterminalFlags;
+    std::unordered_map<std::string, Symbol> ids;
+    std::vector<Symbol> terminalList;
+    std::vector<Symbol> nonterminalList;
+    std::vector<uint32_t> ordinals;
+    Symbol start = INVALID;
+    Symbol end = INVALID;
+
+    std::vector<Symbol> productionLhs;
+    std::vector<uint32_t> bodyStart;
+    std::vector<Symbol> bodies;
+    // Por ordinal de nao-terminal, com sentinela no fim
+    std::vector<uint32_t> firstProduction;
+
+    // Forma editavel usada pelas transformacoes
+    using Body = std::vector<Symbol>;
+    using Rules = std::vector<std::pair<Symbol, std::vector<Body>>>;
+    Rules unpack() const;
+    void pack(const Rules &rules);
+
+    Symbol intern(const std::string &name, bool nonterminal);
+    // base', base'', ... ainda nao usado
+    Symbol freshNonterminal(Symbol base);
+};
+
+#endif
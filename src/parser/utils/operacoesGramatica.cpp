@@ -1,50 +1,80 @@
-#include <iostream>
-#include <vector>
-#include <string>
-#include <map>
+#include "operacoesGramatica.h"
+#include "Grammar.h"
+#include <sstream>
 
 using namespace std;
 
-typedef vector<string> Regras;
-typedef map<string, Regras> Gramatica;
+vector<string> simbolosDaRegra(const string& regra) {
+    vector<string> simbolos;
+    istringstream entrada(regra);
+    string simbolo;
+    while (entrada >> simbolo) {
+        simbolos.push_back(simbolo);
+    }
+    return simbolos;
+}
+
+// As operacoes abaixo convertem para Grammar (simbolos internados, conjuntos
+// em bits), aplicam a transformacao e voltam para o formato de texto
 
 void removerRecursaoEsquerda(Gramatica& gramatica) {
-    Gramatica novasProducoes;
+    Grammar grammar = Grammar::fromRules(gramatica);
+    grammar.removeLeftRecursion();
+    gramatica = grammar.toRules();
+}
 
-    for (const auto& [naoTerminal, regras] : gramatica) {
-        Regras recursivas;
-        Regras naoRecursivas;
-        string novoNaoTerminal = naoTerminal + "'";
+void fatorarEsquerda(Gramatica& gramatica) {
+    Grammar grammar = Grammar::fromRules(gramatica);
+    grammar.leftFactor();
+    gramatica = grammar.toRules();
+}
 
-        // Separando regras não recursivas das recursivas
-        for (const string& regra : regras) {
-            if (regra.rfind(naoTerminal, 0) == 0) {
-                // Se a regra começa com o não-terminal, é recursiva
-                recursivas.push_back(regra.substr(naoTerminal.size()) + novoNaoTerminal);
-            } else {
-                // Caso contrário, é não recursiva
-                naoRecursivas.push_back(regra + " " + novoNaoTerminal);
-            }
-        }
+void removerInalcancaveis(Gramatica& gramatica, const string& inicial) {
+    Grammar grammar = Grammar::fromRules(gramatica, inicial);
+    grammar.removeUnreachable();
+    gramatica = grammar.toRules();
+}
 
-        if (!recursivas.empty()) {
-            // Adiciona as produções não recursivas para o não-terminal original
-            novasProducoes[naoTerminal] = naoRecursivas;
+void transformarParaLL1(Gramatica& gramatica, const string& inicial) {
+    Grammar grammar = Grammar::fromRules(gramatica, inicial);
+    grammar.prepareForLL1();
+    gramatica = grammar.toRules();
+}
 
-            // Adiciona as produções recursivas para o novo não-terminal
-            novasProducoes[novoNaoTerminal] = recursivas;
-            novasProducoes[novoNaoTerminal].push_back(" ");  // Produção para ε (vazio)
-        } else {
-            // Se não há regras recursivas, mantemos as regras originais
-            novasProducoes[naoTerminal] = regras;
+// Conjunto em bits -> nomes dos terminais
+static set<string> nomesDaLinha(const Grammar& grammar, const TerminalSets& conjuntos, size_t linha) {
+    set<string> nomes;
+    for (size_t t = 0; t < grammar.terminals().size(); t++) {
+        if (conjuntos.contains(linha, t)) {
+            nomes.insert(grammar.name(grammar.terminals()[t]));
         }
     }
-
-    gramatica = novasProducoes;
+    return nomes;
 }
 
+Conjuntos calcularFirst(const Gramatica& gramatica) {
+    Grammar grammar = Grammar::fromRules(gramatica);
+    Grammar::Analysis analise = grammar.analyze();
+    Conjuntos first;
+    for (size_t i = 0; i < grammar.nonterminals().size(); i++) {
+        set<string>& destino = first[grammar.name(grammar.nonterminals()[i])];
+        destino = nomesDaLinha(grammar, analise.first, i);
+        if (analise.nullable[i]) {
+            destino.insert("");
+        }
+    }
+    return first;
+}
 
-
+Conjuntos calcularFollow(const Gramatica& gramatica, const string& inicial) {
+    Grammar grammar = Grammar::fromRules(gramatica, inicial);
+    Grammar::Analysis analise = grammar.analyze();
+    Conjuntos follow;
+    for (size_t i = 0; i < grammar.nonterminals().size(); i++) {
+        follow[grammar.name(grammar.nonterminals()[i])] = nomesDaLinha(grammar, analise.follow, i);
+    }
+    return follow;
+}
 
 Gramatica getGramatica(){
     Gramatica gramatica = {
@@ -0,0 +1,78 @@
+#ifndef OPERACOES_GRAMATICA_H
+#define OPERACOES_GRAMATICA_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Cada regra e uma sequencia de simbolos separados por espaco; "" e ε.
+// Nao-terminais sao as chaves da gramatica, o resto e terminal.
+typedef std::vector<std::string> Regras;
+typedef std::map<std::string, Regras> Gramatica;
+// FIRST ou FOLLOW de cada nao-terminal; "" representa ε e "$" o fim da entrada
+typedef std::map<std::string, std::set<std::string>> Conjuntos;
+
+Gramatica getGramatica();
+
+// getGramatica() ja passada por transformarParaLL1, escrita em texto para o
+// compilador montar a tabela LL(1) em tempo de compilacao (StaticLL1Table.h).
+// Uma cabeca por linha, alternativas separadas por "|", ε para o vazio; a
+// primeira cabeca e a inicial. --ll1-report confere se continua igual.
+inline constexpr std::string_view GRAMATICA_LL1 = R"(
+programa -> program id ; declarações_variáveis declarações_de_subprogramas comando_composto .
+argumentos -> ( lista_de_parametros ) | ε
+comando -> id comando' | comando_composto | if expressão then comando parte_else | while expressão do comando
+comando_composto -> begin comandos_opcionais end
+comandos_opcionais -> lista_de_comandos | ε
+declaração_de_subprograma -> procedure id argumentos ; declarações_variáveis declarações_de_subprogramas comando_composto
+declarações_de_subprogramas -> declarações_de_subprogramas'
+declarações_de_subprogramas' -> declaração_de_subprograma ; declarações_de_subprogramas' | ε
+declarações_variáveis -> var lista_declarações_variáveis | ε
+expressão -> expressão_simples expressão'
+expressão_simples -> termo expressão_simples' | sinal termo expressão_simples'
+expressão_simples' -> op_aditivo termo expressão_simples' | ε
+fator -> id fator' | num_int | num_real | true | false | ( expressão ) | not fator
+lista_de_comandos -> comando lista_de_comandos'
+lista_de_comandos' -> ; comando lista_de_comandos' | ε
+lista_de_expressões -> expressão lista_de_expressões'
+lista_de_expressões' -> , expressão lista_de_expressões' | ε
+lista_de_identificadores -> id lista_de_identificadores'
+lista_de_identificadores' -> , id lista_de_identificadores' | ε
+lista_de_parametros -> lista_de_identificadores : tipo lista_de_parametros'
+lista_de_parametros' -> ; lista_de_identificadores : tipo lista_de_parametros' | ε
+lista_declarações_variáveis -> lista_de_identificadores : tipo ; lista_declarações_variáveis'
+lista_declarações_variáveis' -> lista_de_identificadores : tipo ; lista_declarações_variáveis' | ε
+op_aditivo -> + | - | or
+op_multiplicativo -> * | / | and
+op_relacional -> = | < | > | <= | >= | <>
+parte_else -> else comando | ε
+sinal -> + | -
+termo -> fator termo'
+termo' -> op_multiplicativo fator termo' | ε
+tipo -> integer | real | boolean
+ativação_de_procedimento' -> ε | ( lista_de_expressões )
+expressão' -> ε | op_relacional expressão_simples
+fator' -> ε | ( lista_de_expressões )
+comando' -> := expressão | ativação_de_procedimento'
+)";
+
+std::vector<std::string> simbolosDaRegra(const std::string &regra);
+
+// Recursao direta e indireta
+void removerRecursaoEsquerda(Gramatica &gramatica);
+// Junta alternativas com o mesmo prefixo: A -> a b | a c vira A -> a A', A' -> b | c
+void fatorarEsquerda(Gramatica &gramatica);
+// Remove os nao-terminais que nao sao alcancaveis a partir de inicial
+void removerInalcancaveis(Gramatica &gramatica, const std::string &inicial);
+// Recursao a esquerda, fatoracao e, quando alternativas com prefixos
+// diferentes ainda disputam o mesmo terminal, substituicao do nao-terminal
+// inicial delas pelas suas regras, seguida de nova fatoracao
+void transformarParaLL1(Gramatica &gramatica, const std::string &inicial);
+
+// Conjuntos calculados sobre Grammar; FIRST contem "" para os anulaveis
+Conjuntos calcularFirst(const Gramatica &gramatica);
+Conjuntos calcularFollow(const Gramatica &gramatica, const std::string &inicial);
+
+#endif
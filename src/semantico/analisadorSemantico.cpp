@@ -1,8 +1,8 @@
 #include <iostream>
-#include <stack>
 #include <unordered_map>
 #include <string>
 #include <vector>
+#include <optional>
 #include <stdexcept>
 #include "../lexical/Token/Token.h"
 
@@ -20,7 +20,8 @@ struct Simbolo
 {
     Tipo tipo;
     bool inicializado;
-    std::string valor;
+    // Valor inicial ja decodificado pelo Scanner (integer ou real, conforme tipo)
+    NumericValue valor;
 };
 
 
@@ -37,74 +38,87 @@ struct Procedimento
 
 
 
+// As tabelas sao indexadas pelo SymbolId que o Scanner ja atribuiu ao nome,
+// entao cada consulta custa um hash de inteiro em vez de um hash de string.
 class TabelaSimbolos{
     private:
-        std::unordered_map<std::string,Simbolo> variaveis;
-        std::unordered_map<std::string,Funcao> funcoes;
-        std::unordered_map<std::string,Procedimento> procedimentos;
+        std::unordered_map<SymbolId,Simbolo> variaveis;
+        std::unordered_map<SymbolId,Funcao> funcoes;
+        std::unordered_map<SymbolId,Procedimento> procedimentos;
+
+        static std::string nomeDe(SymbolId id){
+            return std::string(Interner::global().name(id));
+        }
     public:
         //insere uma varivel com valor opcional na tabela
-        void inserirVariavel(const std::string &nome, Tipo tipo,const std::string &valor){
-            variaveis[nome] = {tipo,!valor.empty(),valor};
+        void inserirVariavel(SymbolId nome, Tipo tipo,std::optional<NumericValue> valor){
+            variaveis[nome] = {tipo,valor.has_value(),valor.value_or(NumericValue{0})};
         }
 
-        void inserirFuncao(const std::string &nome, Tipo tipoRetorno, const std::vector<Tipo> &parametros){
+        void inserirFuncao(SymbolId nome, Tipo tipoRetorno, const std::vector<Tipo> &parametros){
             funcoes[nome] = {tipoRetorno,parametros};
         }
 
-        void inserirProcedimento(const std::string &nome, const std::vector<Tipo> &parametros){
+        void inserirProcedimento(SymbolId nome, const std::vector<Tipo> &parametros){
             procedimentos[nome] = {parametros};
         }
 
-        bool verificaVariavelExiste(const std::string &nome){
+        bool verificaVariavelExiste(SymbolId nome) const{
             return variaveis.find(nome) != variaveis.end();
         }
 
-        bool verificaFuncaoExiste(const std::string &nome){
+        bool verificaFuncaoExiste(SymbolId nome) const{
             return funcoes.find(nome) != funcoes.end();
         }
 
-        bool verificaProcedimentoExiste(const std::string &nome){
+        bool verificaProcedimentoExiste(SymbolId nome) const{
             return procedimentos.find(nome) != procedimentos.end();
         }
 
+        // Busca a variavel uma unica vez; nullptr se nao existir neste escopo
+        const Simbolo *buscarVariavel(SymbolId nome) const{
+            auto it = variaveis.find(nome);
+            return it != variaveis.end() ? &it->second : nullptr;
+        }
+
          // Obter tipo da variável
-        Tipo getTipoVariavel(const std::string &nome) {
-            if (verificaVariavelExiste(nome)) {
-                return variaveis[nome].tipo;
-            }
-            return Tipo::UNDEFINED;
+        Tipo getTipoVariavel(SymbolId nome) const {
+            const Simbolo *simbolo = buscarVariavel(nome);
+            return simbolo ? simbolo->tipo : Tipo::UNDEFINED;
         }
 
         // Obter valor da variável
-        std::string getValorVariavel(const std::string &nome) {
-            if (verificaVariavelExiste(nome)) {
-                return variaveis[nome].valor;
+        NumericValue getValorVariavel(SymbolId nome) const {
+            if (const Simbolo *simbolo = buscarVariavel(nome)) {
+                return simbolo->valor;
             }
-            throw std::runtime_error("Variável não encontrada: " + nome);
+            throw std::runtime_error("Variável não encontrada: " + nomeDe(nome));
         }
 
-        Funcao getFuncao(const std::string &nome){
-            if(verificaFuncaoExiste(nome)){
-                return funcoes[nome];
+        Funcao getFuncao(SymbolId nome) const{
+            auto it = funcoes.find(nome);
+            if(it != funcoes.end()){
+                return it->second;
             }
-            throw std::runtime_error("Função não encontrada: " + nome);
+            throw std::runtime_error("Função não encontrada: " + nomeDe(nome));
         }
 
         // Obter informações do procedimento
-        Procedimento getProcedimento(const std::string &nome) {
-            if (procedimentos.find(nome) != procedimentos.end()) {
-                return procedimentos[nome];
+        Procedimento getProcedimento(SymbolId nome) const {
+            auto it = procedimentos.find(nome);
+            if (it != procedimentos.end()) {
+                return it->second;
             }
-            throw std::runtime_error("Procedimento não encontrado: " + nome);
+            throw std::runtime_error("Procedimento não encontrado: " + nomeDe(nome));
         }
 
         // Marcar variável como inicializada
-        void marcarInicializada(const std::string &nome) {
-            if (variaveis.find(nome) != variaveis.end()) {
-                variaveis[nome].inicializado = true;
+        void marcarInicializada(SymbolId nome) {
+            auto it = variaveis.find(nome);
+            if (it != variaveis.end()) {
+                it->second.inicializado = true;
             } else {
-                throw std::runtime_error("Variável não encontrada: " + nome);
+                throw std::runtime_error("Variável não encontrada: " + nomeDe(nome));
             }
         }
         
@@ -113,7 +127,8 @@ class TabelaSimbolos{
 
 class AnalisadorSemantico {
 private:
-    std::stack<TabelaSimbolos> scopeStack;
+    // Pilha de escopos; vector para percorrer do topo a base sem copiar
+    std::vector<TabelaSimbolos> scopeStack;
     int estadoAtual;
     
     Tipo mapTokenTypeToTipo(TokenType tokenType) {
@@ -127,48 +142,49 @@ private:
 
 public:
     AnalisadorSemantico() {
-        scopeStack.push(TabelaSimbolos());
+        scopeStack.push_back(TabelaSimbolos());
     }
 
     void entradaEscopo() {
-        scopeStack.push(TabelaSimbolos());
+        scopeStack.push_back(TabelaSimbolos());
     }
 
     void saidaEscopo() {
         if (!scopeStack.empty()) {
-            scopeStack.pop();
+            scopeStack.pop_back();
         } else {
             throw std::runtime_error("Erro: Tentativa de sair de um escopo inexistente");
         }
     }
 
-    void declararVariavel(const std::string &nome, Tipo tipo, const std::string &valor = "") {
-        if (scopeStack.top().verificaVariavelExiste(nome)) {
-            throw std::runtime_error("Erro: Variável já declarada no escopo atual: " + nome);
+    static std::string nomeDe(SymbolId id) {
+        return std::string(Interner::global().name(id));
+    }
+
+    void declararVariavel(SymbolId nome, Tipo tipo, std::optional<NumericValue> valor = std::nullopt) {
+        if (scopeStack.back().verificaVariavelExiste(nome)) {
+            throw std::runtime_error("Erro: Variável já declarada no escopo atual: " + nomeDe(nome));
         } else {
-            scopeStack.top().inserirVariavel(nome, tipo, valor);
+            scopeStack.back().inserirVariavel(nome, tipo, valor);
         }
     }
 
-    Tipo checkVariavel(const std::string &nome) {
-        std::stack<TabelaSimbolos> tempStack = scopeStack;
-
-        while (!tempStack.empty()) {
-            if (tempStack.top().verificaVariavelExiste(nome)) {
-                return tempStack.top().getTipoVariavel(nome);
+    Tipo checkVariavel(SymbolId nome) {
+        for (auto escopo = scopeStack.rbegin(); escopo != scopeStack.rend(); ++escopo) {
+            if (const Simbolo *simbolo = escopo->buscarVariavel(nome)) {
+                return simbolo->tipo;
             }
-            tempStack.pop();
         }
 
-        throw std::runtime_error("Erro: Variável não declarada: " + nome);
+        throw std::runtime_error("Erro: Variável não declarada: " + nomeDe(nome));
     }
 
-    void declararFuncao(const std::string &nome, Tipo tipoRetorno, std::vector<Tipo> &parametros) {
-        if (scopeStack.top().verificaFuncaoExiste(nome)) {
-            throw std::runtime_error("Erro: Função já declarada no escopo atual: " + nome);
+    void declararFuncao(SymbolId nome, Tipo tipoRetorno, std::vector<Tipo> &parametros) {
+        if (scopeStack.back().verificaFuncaoExiste(nome)) {
+            throw std::runtime_error("Erro: Função já declarada no escopo atual: " + nomeDe(nome));
         } else {
             Tipo info = {tipoRetorno};
-            scopeStack.top().inserirFuncao(nome, info,parametros);
+            scopeStack.back().inserirFuncao(nome, info,parametros);
             entradaEscopo(); // Novo escopo para as variáveis da função
         }
     }
@@ -178,10 +194,10 @@ public:
     }
 
 
-    void checkAtribuicao(const std::string &nome, Tipo valorTipo) {
+    void checkAtribuicao(SymbolId nome, Tipo valorTipo) {
         Tipo varTipo = checkVariavel(nome);
         if (varTipo != valorTipo) {
-            throw std::runtime_error("Erro: Atribuição inválida para a variável '" + nome +
+            throw std::runtime_error("Erro: Atribuição inválida para a variável '" + nomeDe(nome) +
                                      "'. Esperado tipo: " + std::to_string(static_cast<int>(varTipo)) +
                                      ", mas encontrou tipo: " + std::to_string(static_cast<int>(valorTipo)));
         }
@@ -218,8 +234,13 @@ public:
                 }
                 //estado para declaração de variáveis
                 case 1:{
-                    if(scopeStack.top().verificaVariavelExiste(token.getText()) == false){
-                        scopeStack.top().inserirVariavel(token.getText(),mapTokenTypeToTipo(token.getType()),token.getText());
+                    SymbolId nome = token.getSymbol();
+                    if(scopeStack.back().verificaVariavelExiste(nome) == false){
+                        std::optional<NumericValue> valor;
+                        if(token.getType() == TokenType::NUMBER || token.getType() == TokenType::FLOAT_NUMBER){
+                            valor = token.getValue();
+                        }
+                        scopeStack.back().inserirVariavel(nome,mapTokenTypeToTipo(token.getType()),valor);
                         estadoAtual = 0;
 
                         break;
@@ -0,0 +1,124 @@
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "../src/lexical/Scanner/Scanner.h"
+#include "../src/parser/Parser.h"
+#include "Check.h"
+
+// Lexar e analisar nao aloca por token: o mesmo programa com 4x mais
+// procedimentos faz praticamente o mesmo numero de operator new (so o
+// crescimento geometrico dos vetores do TokenBuffer e da Ast).
+
+namespace
+{
+    bool counting = false;
+    size_t allocations = 0;
+
+    void *allocate(size_t size)
+    {
+        if (counting)
+        {
+            allocations++;
+        }
+        if (void *block = std::malloc(size == 0 ? 1 : size))
+        {
+            return block;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+void *operator new(size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new[](size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void *block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete[](void *block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void *block, size_t) noexcept
+{
+    std::free(block);
+}
+
+void operator delete[](void *block, size_t) noexcept
+{
+    std::free(block);
+}
+
+namespace
+{
+    struct Count
+    {
+        size_t tokens;
+        size_t allocations;
+    };
+
+    // Os procedimentos do fixture repetidos copies vezes, com o mesmo
+    // cabecalho e o mesmo corpo principal
+    std::string repeatProcedures(const std::string &program, size_t copies)
+    {
+        size_t first = program.find("\nprocedure");
+        size_t body = program.rfind("\nbegin\n");
+        std::string text = program.substr(0, first);
+        for (size_t i = 0; i < copies; i++)
+        {
+            text += program.substr(first, body - first);
+        }
+        return text + program.substr(body);
+    }
+
+    Count lexAndParse(const std::string &text)
+    {
+        SourceBuffer source = SourceBuffer::fromString(text);
+        allocations = 0;
+        counting = true;
+        Scanner scanner(std::move(source));
+        TokenBuffer tokens = scanner.tokenizeAll();
+        TokenCursor cursor(tokens);
+        Ast ast;
+        Parser parser(cursor, ast);
+        parser.parseProgram();
+        counting = false;
+        check(parser.getDiagnostics().empty(), "program parses");
+        return {tokens.size(), allocations};
+    }
+}
+
+int main()
+{
+    std::ifstream file("tests/fixtures/program.mc");
+    std::ostringstream program;
+    program << file.rdbuf();
+    check(file.good() && program.str().find("\nprocedure") != std::string::npos, "read tests/fixtures/program.mc");
+
+    // A primeira passada interna os identificadores do fixture no Interner
+    // global; dai em diante nenhum nome e novo
+    lexAndParse(repeatProcedures(program.str(), 1));
+    Count small = lexAndParse(repeatProcedures(program.str(), 2000));
+    Count large = lexAndParse(repeatProcedures(program.str(), 8000));
+
+    std::cout << small.tokens << " tokens: " << small.allocations << " allocations; " << large.tokens
+              << " tokens: " << large.allocations << " allocations" << std::endl;
+    check(large.tokens > 3 * small.tokens, "the large input has ~4x the tokens");
+    // Dobrar a entrada custa umas poucas realocacoes por vetor, nunca uma por token
+    check(large.allocations <= small.allocations + 64, "allocations do not grow with the token count");
+    check(large.allocations < large.tokens / 1000, "far fewer allocations than tokens");
+
+    return checkResult("AllocationTest");
+}
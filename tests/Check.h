@@ -0,0 +1,36 @@
+#ifndef TESTS_CHECK_H
+#define TESTS_CHECK_H
+
+#include <iostream>
+#include <string>
+
+// Verificacao minima dos testes em tests/: cada falha e contada (so as
+// primeiras sao impressas), o teste segue ate o fim e main devolve
+// checkResult() para o tests/run.sh
+inline int &checkFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline bool check(bool condition, const std::string &what)
+{
+    if (!condition && ++checkFailures() <= 20)
+    {
+        std::cerr << "FAIL: " << what << std::endl;
+    }
+    return condition;
+}
+
+inline int checkResult(const char *name)
+{
+    if (checkFailures() == 0)
+    {
+        std::cout << name << ": ok" << std::endl;
+        return 0;
+    }
+    std::cout << name << ": " << checkFailures() << " failure(s)" << std::endl;
+    return 1;
+}
+
+#endif
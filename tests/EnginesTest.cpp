@@ -0,0 +1,245 @@
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#include "../src/lexical/Scanner/Scanner.h"
+#include "../src/parser/Parser.h"
+#include "../src/parser/LL1/PredictiveParser.h"
+#include "../src/parser/LL1/StaticLL1Table.h"
+#include "../src/parser/LR/ShiftReduceParser.h"
+#include "Check.h"
+
+// O mesmo programa pelos tres analisadores (descida recursiva, LL(1) e
+// LALR(1)): todos tem de aceitar ou todos rejeitar.
+
+namespace
+{
+    struct Verdicts
+    {
+        bool recursive;
+        bool predictive;
+        bool shiftReduce;
+    };
+
+    Verdicts parseWithAll(const std::string &text, const LALRTable &table)
+    {
+        Scanner scanner(SourceBuffer::fromString(text));
+        TokenBuffer tokens = scanner.tokenizeAll();
+        Verdicts verdicts;
+
+        TokenCursor recursiveCursor(tokens);
+        Ast ast;
+        Parser parser(recursiveCursor, ast);
+        NodeId root = parser.parseProgram();
+        verdicts.recursive = parser.getDiagnostics().empty() && root != NO_NODE;
+
+        TokenCursor predictiveCursor(tokens);
+        PredictiveParser predictive(predictiveCursor, LANGUAGE_LL1_TABLE);
+        verdicts.predictive = predictive.parse();
+
+        TokenCursor shiftReduceCursor(tokens);
+        ShiftReduceParser shiftReduce(shiftReduceCursor, table);
+        verdicts.shiftReduce = shiftReduce.parse();
+        return verdicts;
+    }
+
+    void expect(const std::string &name, const std::string &text, bool accepted, const LALRTable &table)
+    {
+        Verdicts verdicts = parseWithAll(text, table);
+        check(verdicts.recursive == accepted, name + ": Parser");
+        check(verdicts.predictive == accepted, name + ": --ll1");
+        check(verdicts.shiftReduce == accepted, name + ": --lalr");
+    }
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path);
+        check(file.good(), "open " + path);
+        std::ostringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+
+    // Um comando dentro de um programa minimo
+    std::string program(const std::string &command)
+    {
+        return "program p ;\nvar a , b : integer ;\nbegin\n  " + command + "\nend .\n";
+    }
+
+    // Um procedimento q com o cabecalho dado, chamado no corpo do programa
+    std::string withProcedure(const std::string &header)
+    {
+        return "program p ;\nvar a , b : integer ;\n" + header +
+               "\nvar c : real ;\nbegin\n  a := 1\nend ;\nbegin\n  q\nend .\n";
+    }
+
+    template <typename Call>
+    bool throwsOutOfRange(const Call &call)
+    {
+        try
+        {
+            call();
+        }
+        catch (const std::out_of_range &)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    // setErrorLimit(n) guarda no maximo n erros em cada analisador; 0 e recusado
+    void checkErrorLimit(const LALRTable &table)
+    {
+        Scanner scanner(SourceBuffer::fromString(program("a := ;\n  b := ;\n  a := 1 1")));
+        TokenBuffer tokens = scanner.tokenizeAll();
+
+        TokenCursor recursiveCursor(tokens);
+        Ast ast;
+        Parser parser(recursiveCursor, ast);
+        check(throwsOutOfRange([&]() { parser.setErrorLimit(0); }), "setErrorLimit(0): Parser");
+        parser.setErrorLimit(1);
+        parser.parseProgram();
+        check(parser.getDiagnostics().size() == 1, "error limit 1: Parser");
+
+        TokenCursor predictiveCursor(tokens);
+        PredictiveParser predictive(predictiveCursor, LANGUAGE_LL1_TABLE);
+        check(throwsOutOfRange([&]() { predictive.setErrorLimit(0); }), "setErrorLimit(0): --ll1");
+        predictive.setErrorLimit(1);
+        predictive.parse();
+        check(predictive.getDiagnostics().size() == 1, "error limit 1: --ll1");
+
+        TokenCursor shiftReduceCursor(tokens);
+        ShiftReduceParser shiftReduce(shiftReduceCursor, table);
+        check(throwsOutOfRange([&]() { shiftReduce.setErrorLimit(0); }), "setErrorLimit(0): --lalr");
+        shiftReduce.setErrorLimit(1);
+        shiftReduce.parse();
+        check(shiftReduce.getDiagnostics().size() == 1, "error limit 1: --lalr");
+    }
+
+    // Erros lexicos e sintaticos usam a mesma posicao: linha e coluna a partir
+    // de 1, no inicio do token
+    void checkPositions()
+    {
+        std::string text = program("a := @ ;\n  b := ;\n  a := 1");
+        Scanner scanner(SourceBuffer::fromString(text));
+        scanner.setErrorRecovery(true);
+        TokenBuffer tokens = scanner.tokenizeAll();
+        check(scanner.getDiagnostics().size() == 1, "one lexical error");
+        if (!scanner.getDiagnostics().empty())
+        {
+            std::string message = scanner.renderDiagnostic(scanner.getDiagnostics()[0]);
+            check(message.find("row 4, col 8") != std::string::npos, "lexical error position: " + message);
+        }
+
+        TokenCursor cursor(tokens);
+        Ast ast;
+        Parser parser(cursor, ast);
+        parser.parseProgram();
+        std::vector<SourceLocation> locations;
+        for (const SyntaxDiagnostic &diagnostic : parser.getDiagnostics())
+        {
+            locations.push_back(scanner.locate(diagnostic.offset));
+        }
+        // O ERROR do "@" e o ";" de "b := ;"
+        check(locations.size() == 2, "two syntax errors");
+        if (locations.size() == 2)
+        {
+            check(locations[0].row == 4 && locations[0].col == 8, "syntax error position on the @");
+            check(locations[1].row == 5 && locations[1].col == 8, "syntax error position on the ;");
+        }
+    }
+
+    // Le text de um pipe com uma janela de 256 bytes, como "./compiler -", e
+    // devolve os erros que parse(cursor) encontrar
+    template <typename Parse>
+    std::vector<SyntaxDiagnostic> parseStream(const std::string &text, const Parse &parse)
+    {
+        int pipeEnds[2];
+        check(pipe(pipeEnds) == 0, "pipe");
+        check(write(pipeEnds[1], text.data(), text.size()) == static_cast<ssize_t>(text.size()), "write to pipe");
+        close(pipeEnds[1]);
+        Scanner stream(std::make_unique<StreamSource>(pipeEnds[0], 256));
+        TokenCursor cursor(stream);
+        std::vector<SyntaxDiagnostic> diagnostics = parse(cursor);
+        close(pipeEnds[0]);
+        return diagnostics;
+    }
+
+    // No streaming a janela ja descartou o token quando os erros sao
+    // impressos: a posicao guardada no erro tem de ser a da leitura inteira
+    void checkStreamPositions(const std::string &engine, const std::string &text,
+                              const std::vector<SyntaxDiagnostic> &diagnostics)
+    {
+        Scanner scanner(SourceBuffer::fromString(text));
+        check(diagnostics.size() == 2, "two syntax errors from a stream: " + engine);
+        for (const SyntaxDiagnostic &diagnostic : diagnostics)
+        {
+            SourceLocation expected = scanner.locate(diagnostic.offset);
+            check(diagnostic.location.row == expected.row && diagnostic.location.col == expected.col,
+                  "stream error position: " + engine + " at row " + std::to_string(expected.row));
+        }
+    }
+
+    void checkStreamPositions(const LALRTable &table)
+    {
+        std::string commands;
+        for (int i = 0; i < 400; i++)
+        {
+            commands += "a := a + " + std::to_string(i) + " ;\n  ";
+        }
+        std::string text = program(commands + "b := ;\n  a := a + 1 ;\n  b := b *");
+
+        checkStreamPositions("Parser", text, parseStream(text, [](TokenCursor &cursor) {
+                                 Ast ast;
+                                 Parser parser(cursor, ast);
+                                 parser.parseProgram();
+                                 return parser.getDiagnostics();
+                             }));
+        checkStreamPositions("--ll1", text, parseStream(text, [](TokenCursor &cursor) {
+                                 PredictiveParser parser(cursor, LANGUAGE_LL1_TABLE);
+                                 parser.parse();
+                                 return parser.getDiagnostics();
+                             }));
+        checkStreamPositions("--lalr", text, parseStream(text, [&table](TokenCursor &cursor) {
+                                 ShiftReduceParser parser(cursor, table);
+                                 parser.parse();
+                                 return parser.getDiagnostics();
+                             }));
+    }
+}
+
+int main()
+{
+    LALRTable table = LALRTable::fromLanguageGrammar();
+
+    expect("fixtures/program.mc", readFile("tests/fixtures/program.mc"), true, table);
+
+    expect("call in expression", program("a := f ( a , b ) ;\n  b := a"), true, table);
+    expect("nested calls", program("a := f ( g ( a , 1 ) , - b , ( h ( a > b ) ) ) * f ( 1 )"), true, table);
+    expect("call command", program("p ( f ( a , b ) , a ) ;\n  p"), true, table);
+    expect("dangling else", program("if a then if b then a := 1 else a := 2"), true, table);
+
+    expect("empty argument", program("a := f ( a , )"), false, table);
+    expect("unclosed call", program("a := f ( a , b ;\n  b := a"), false, table);
+    expect("chained relation", program("a := a < b < 1"), false, table);
+    expect("boolean literals", program("a := true and not false ;\n  b := f ( true ) = false"), true, table);
+    expect("equality", program("if a = 1 then b := a = b"), true, table);
+    expect("chained equality", program("a := a = b = 1"), false, table);
+    expect("assign to true", program("true := 1"), false, table);
+    expect("false as a variable", "program p ;\nvar false : boolean ;\nbegin\n  a := 1\nend .\n", false, table);
+    expect("one parameter", withProcedure("procedure q ( a : integer ) ;"), true, table);
+    expect("parameter groups", withProcedure("procedure q ( a , b : integer ; c : real ; d : boolean ) ;"), true, table);
+    expect("empty parameters", withProcedure("procedure q ( ) ;"), false, table);
+    expect("parameter without type", withProcedure("procedure q ( a ) ;"), false, table);
+    expect("trailing parameter ;", withProcedure("procedure q ( a : integer ; ) ;"), false, table);
+    expect("missing end", "program p ;\nbegin\n  a := 1\n.\n", false, table);
+
+    checkErrorLimit(table);
+    checkPositions();
+    checkStreamPositions(table);
+
+    return checkResult("EnginesTest");
+}
@@ -0,0 +1,27 @@
+#include "../src/parser/LL1/LL1Table.h"
+#include "../src/parser/LL1/StaticLL1Table.h"
+#include "Check.h"
+
+// GRAMATICA_LL1 e uma copia, em texto, de getGramatica() ja passada por
+// prepareForLL1, e dela sai a tabela constexpr que --ll1 usa. Se as duas
+// divergirem, --ll1 reconhece outra linguagem: a tabela gerada agora de
+// getGramatica() tem de escolher as mesmas producoes nas mesmas celulas.
+
+int main()
+{
+    LL1Table generated = LL1Table::fromLanguageGrammar();
+    const LL1TableView &view = generated.view();
+    check(view.terminalCount == LANGUAGE_LL1_TABLE.terminalCount, "terminal count");
+    check(view.symbolCount == LANGUAGE_LL1_TABLE.symbolCount, "symbol count");
+    check(view.sameEntries(LANGUAGE_LL1_TABLE), "GRAMATICA_LL1 out of date with getGramatica() (see --ll1-report)");
+
+    // O unico conflito e o else pendente, resolvido para o if mais interno
+    const std::vector<LL1Conflict> &conflicts = generated.getConflicts();
+    check(conflicts.size() == 1, "one LL(1) conflict");
+    if (!conflicts.empty())
+    {
+        check(conflicts[0].terminal == "else", "the conflict is on else");
+    }
+
+    return checkResult("GrammarTest");
+}
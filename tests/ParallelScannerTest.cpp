@@ -0,0 +1,167 @@
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "../src/lexical/Scanner/Scanner.h"
+#include "Check.h"
+#include "TokenCompare.h"
+
+// Teste diferencial: tokenizeAll com setParallelLexing(0, N) tem de produzir
+// os mesmos tokens, simbolos, valores, diagnosticos e posicoes (locate) que o
+// Scanner sequencial, com entradas que caem em varios trechos: comentarios,
+// erros lexicos com e sem --keep-going e linhas maiores que um trecho.
+
+namespace
+{
+    struct Lexed
+    {
+        std::unique_ptr<Scanner> scanner;
+        TokenBuffer tokens;
+        std::vector<Diagnostic> diagnostics;
+        // Mensagem do primeiro erro sem --keep-going
+        std::string error;
+    };
+
+    // threads == 0: sequencial
+    Lexed lex(const std::string &text, unsigned threads, ScannerEngine engine, bool recovery)
+    {
+        Lexed lexed;
+        lexed.scanner = std::make_unique<Scanner>(SourceBuffer::view(text.data(), text.size()));
+        Scanner &scanner = *lexed.scanner;
+        scanner.setEngine(engine);
+        scanner.setErrorRecovery(recovery);
+        scanner.setParallelLexing(threads == 0 ? SIZE_MAX : 0, threads);
+        try
+        {
+            lexed.tokens = scanner.tokenizeAll();
+        }
+        catch (const std::runtime_error &error)
+        {
+            lexed.error = error.what();
+        }
+        lexed.diagnostics = scanner.getDiagnostics();
+        return lexed;
+    }
+
+    // Linha e coluna de cada token e de cada diagnostico, e as mensagens
+    bool samePositions(Lexed &sequential, Lexed &parallel)
+    {
+        for (uint32_t offset : sequential.tokens.offsets)
+        {
+            SourceLocation a = sequential.scanner->locate(offset);
+            SourceLocation b = parallel.scanner->locate(offset);
+            if (a.row != b.row || a.col != b.col)
+            {
+                return false;
+            }
+        }
+        for (const Diagnostic &diagnostic : sequential.diagnostics)
+        {
+            if (sequential.scanner->renderDiagnostic(diagnostic) != parallel.scanner->renderDiagnostic(diagnostic))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void compareThreads(const std::string &name, const std::string &text)
+    {
+        for (ScannerEngine engine : {ScannerEngine::SWITCH, ScannerEngine::TABLE})
+        {
+            for (bool recovery : {false, true})
+            {
+                Lexed sequential = lex(text, 0, engine, recovery);
+                for (unsigned threads : {1u, 2u, 3u, 4u, 7u})
+                {
+                    Lexed parallel = lex(text, threads, engine, recovery);
+                    std::string what = name + ", " + std::to_string(threads) + " thread(s)" +
+                                       (engine == ScannerEngine::TABLE ? ", table" : "") +
+                                       (recovery ? " (--keep-going)" : "");
+                    check(sequential.error == parallel.error,
+                          what + ": error \"" + sequential.error + "\" vs \"" + parallel.error + "\"");
+                    check(sameTokens(sequential.tokens, parallel.tokens), what + ": tokens");
+                    check(sameDiagnostics(sequential.diagnostics, parallel.diagnostics), what + ": diagnostics");
+                    check(samePositions(sequential, parallel), what + ": locate");
+                }
+            }
+        }
+    }
+
+    // Linhas inteiras, para os cortes (logo depois de um '\n') cairem entre
+    // elas, e linhas longas, que ocupam mais de um trecho sozinhas
+    const char *const LINES[] = {
+        "program p ;",
+        "var x , y_1 : integer ;",
+        "    x := x + 42 * ( y_1 - 007 ) / 3.5 ;",
+        "    if x <= 1.e5 then y := not x else y := true ;",
+        "# comentario ate o fim da linha ; begin end",
+        "    a := b # comentario depois do comando",
+        "while x <> 0 do begin x := x - 1 end ;",
+        "escreve ( f ( a , b ) , - c , 99999999999999999999 ) ;",
+        "    a := 1 @ 2 ;",
+        "    z := 2.5e3 $ w ;",
+        "",
+        "\t\t",
+        "end .",
+    };
+
+    std::string randomInput(std::mt19937 &random)
+    {
+        std::uniform_int_distribution<size_t> line(0, sizeof(LINES) / sizeof(LINES[0]) - 1);
+        std::uniform_int_distribution<int> lines(1, 200);
+        std::bernoulli_distribution longLine(0.05);
+        std::string text;
+        for (int i = lines(random); i > 0; i--)
+        {
+            if (longLine(random))
+            {
+                // Varias linhas coladas numa so, sem '\n' para cortar
+                for (int j = 0; j < 60; j++)
+                {
+                    text += LINES[line(random) % 4];
+                    text += ' ';
+                }
+            }
+            else
+            {
+                text += LINES[line(random)];
+            }
+            text += '\n';
+        }
+        return text;
+    }
+}
+
+int main()
+{
+    std::ifstream file("tests/fixtures/program.mc");
+    std::ostringstream program;
+    program << file.rdbuf();
+    check(file.good(), "read tests/fixtures/program.mc");
+    std::string fixture = program.str();
+    compareThreads("fixtures/program.mc", fixture);
+
+    std::string repeated;
+    for (int i = 0; i < 50; i++)
+    {
+        repeated += fixture;
+    }
+    compareThreads("fixture x50", repeated);
+
+    compareThreads("empty", "");
+    compareThreads("one line, no newline", "program p ; begin a := 1 end .");
+    compareThreads("comment at the end", "program p ;\n# sem newline no fim");
+    compareThreads("errors at both ends", "@ program p ;\nbegin\n  a := 1\nend . $");
+
+    std::mt19937 random(9);
+    for (int i = 0; i < 400; i++)
+    {
+        compareThreads("random input " + std::to_string(i), randomInput(random));
+    }
+
+    return checkResult("ParallelScannerTest");
+}
@@ -0,0 +1,172 @@
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#include "../src/lexical/Scanner/Scanner.h"
+#include "Check.h"
+
+// Scanner::relex contra um tokenizeAll completo: uma sequencia de edicoes
+// aleatorias sobre o fixture, conferindo depois de cada uma os tokens, os
+// valores, os erros lexicos e a faixa devolvida em TokenChange.
+
+namespace
+{
+    // Simbolo do token ou, nos literais, os bits do valor (o indice em
+    // literals muda depois de um relex)
+    uint64_t payload(const TokenBuffer &tokens, size_t index)
+    {
+        if (!TokenBuffer::isNumeric(tokens.kinds[index]))
+        {
+            return tokens.symbols[index];
+        }
+        uint64_t bits;
+        NumericValue value = tokens.literals[tokens.symbols[index]];
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    bool sameTokens(const TokenBuffer &a, const TokenBuffer &b)
+    {
+        if (a.kinds != b.kinds || a.keywords != b.keywords || a.offsets != b.offsets || a.lengths != b.lengths ||
+            a.symbols.size() != b.symbols.size() || a.endOffset != b.endOffset)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (payload(a, i) != payload(b, i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool sameDiagnostics(const std::vector<Diagnostic> &a, const std::vector<Diagnostic> &b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (a[i].offset != b[i].offset || a[i].length != b[i].length || a[i].code != b[i].code)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Tokens fora de [begin, oldEnd) nao mudam, so os seguintes se deslocam
+    bool changeIsTight(const TokenBuffer &before, const TokenBuffer &after, const TokenChange &change, long long delta)
+    {
+        if (change.begin > change.oldEnd || change.begin > change.newEnd || change.oldEnd > before.size() ||
+            change.newEnd > after.size() || before.size() - change.oldEnd != after.size() - change.newEnd)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < change.begin; i++)
+        {
+            if (before.kinds[i] != after.kinds[i] || before.offsets[i] != after.offsets[i])
+            {
+                return false;
+            }
+        }
+        for (size_t i = change.oldEnd, j = change.newEnd; i < before.size(); i++, j++)
+        {
+            if (before.kinds[i] != after.kinds[j] || before.offsets[i] + delta != after.offsets[j])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const char *const INSERTS[] = {"", " ", "\n", "x", "abc", "1", "2.5", "3.", ":=", ":", "<", ">", "=", ";", "(",
+                                   ")", "{", "}", "{ c }", "#", "begin", "end", "procedure p ;", "@", "_", "e", "."};
+
+    void randomEdits(const std::string &program, ScannerEngine engine)
+    {
+        std::mt19937 random(engine == ScannerEngine::TABLE ? 11 : 7);
+        std::string text = program;
+        Scanner incremental(SourceBuffer::fromString(text));
+        incremental.setEngine(engine);
+        incremental.setErrorRecovery(true);
+        TokenBuffer tokens = incremental.tokenizeAll();
+
+        const char *name = engine == ScannerEngine::TABLE ? "table engine" : "switch engine";
+        for (int i = 0; i < 3000; i++)
+        {
+            size_t offset = random() % (text.size() + 1);
+            size_t removed = std::min<size_t>(random() % 6, text.size() - offset);
+            std::string inserted = INSERTS[random() % (sizeof(INSERTS) / sizeof(INSERTS[0]))];
+            text.replace(offset, removed, inserted);
+
+            TokenBuffer before = tokens;
+            TokenChange change = incremental.relex(tokens, SourceEdit{offset, removed, inserted});
+
+            Scanner full(SourceBuffer::fromString(text));
+            full.setEngine(engine);
+            full.setErrorRecovery(true);
+            TokenBuffer expected = full.tokenizeAll();
+
+            std::string what = std::string(name) + ", edit " + std::to_string(i) + " at " + std::to_string(offset);
+            if (!check(sameTokens(tokens, expected), what + ": tokens") ||
+                !check(sameDiagnostics(incremental.getDiagnostics(), full.getDiagnostics()), what + ": diagnostics"))
+            {
+                return;
+            }
+            long long delta = static_cast<long long>(inserted.size()) - static_cast<long long>(removed);
+            check(changeIsTight(before, tokens, change, delta), what + ": TokenChange");
+        }
+    }
+
+    template <typename Exception>
+    bool throws(Scanner &scanner, TokenBuffer &tokens, const SourceEdit &edit)
+    {
+        try
+        {
+            scanner.relex(tokens, edit);
+        }
+        catch (const Exception &)
+        {
+            return true;
+        }
+        return false;
+    }
+}
+
+int main()
+{
+    std::ifstream file("tests/fixtures/program.mc");
+    std::ostringstream program;
+    program << file.rdbuf();
+    check(file.good(), "read tests/fixtures/program.mc");
+
+    randomEdits(program.str(), ScannerEngine::SWITCH);
+    randomEdits(program.str(), ScannerEngine::TABLE);
+
+    // Edicoes fora do fonte sao rejeitadas sem mexer nos tokens
+    Scanner scanner(SourceBuffer::fromString("program p ;"));
+    TokenBuffer tokens = scanner.tokenizeAll();
+    check(throws<std::out_of_range>(scanner, tokens, SourceEdit{12, 0, "x"}), "offset past the end");
+    check(throws<std::out_of_range>(scanner, tokens, SourceEdit{8, 4, ""}), "removal past the end");
+    check(!throws<std::out_of_range>(scanner, tokens, SourceEdit{11, 0, " x"}), "append at the end");
+
+    // Um Scanner em streaming so tem a janela atual
+    int pipeEnds[2];
+    check(pipe(pipeEnds) == 0, "pipe");
+    close(pipeEnds[1]);
+    Scanner stream(std::make_unique<StreamSource>(pipeEnds[0]));
+    TokenBuffer none;
+    check(throws<std::logic_error>(stream, none, SourceEdit{0, 0, "x"}), "stream-backed scanner");
+    close(pipeEnds[0]);
+
+    return checkResult("RelexTest");
+}
@@ -0,0 +1,102 @@
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "../src/lexical/Scanner/Scanner.h"
+#include "Check.h"
+#include "TokenCompare.h"
+
+// Teste diferencial: o DFA dirigido por tabelas (ScannerEngine::TABLE) tem de
+// produzir os mesmos tokens, valores e erros lexicos que o automato com switch,
+// no fixture e em entradas aleatorias montadas de pedacos da linguagem.
+
+namespace
+{
+    struct Lexed
+    {
+        TokenBuffer tokens;
+        std::vector<Diagnostic> diagnostics;
+        // Mensagem do primeiro erro sem --keep-going
+        std::string error;
+    };
+
+    Lexed lex(const std::string &text, ScannerEngine engine, bool recovery)
+    {
+        Scanner scanner(SourceBuffer::fromString(text));
+        scanner.setEngine(engine);
+        scanner.setErrorRecovery(recovery);
+        Lexed lexed;
+        try
+        {
+            lexed.tokens = scanner.tokenizeAll();
+        }
+        catch (const std::runtime_error &error)
+        {
+            lexed.error = error.what();
+        }
+        lexed.diagnostics = scanner.getDiagnostics();
+        return lexed;
+    }
+
+    void compareEngines(const std::string &name, const std::string &text)
+    {
+        for (bool recovery : {false, true})
+        {
+            Lexed switched = lex(text, ScannerEngine::SWITCH, recovery);
+            Lexed table = lex(text, ScannerEngine::TABLE, recovery);
+            std::string what = name + (recovery ? " (--keep-going)" : "");
+            check(switched.error == table.error, what + ": error \"" + switched.error + "\" vs \"" + table.error + "\"");
+            check(sameTokens(switched.tokens, table.tokens), what + ": tokens");
+            check(sameDiagnostics(switched.diagnostics, table.diagnostics), what + ": diagnostics");
+        }
+    }
+
+    // Pedacos validos e invalidos, colados com ou sem espaco entre eles
+    const char *const PIECES[] = {
+        "program", "var", "integer", "real", "boolean", "procedure", "begin", "end", "if", "then", "else",
+        "while", "do", "not", "and", "or", "AND", "Or", "true", "false", "x", "x_1", "abc", "_a", "a1b2",
+        "0", "42", "007", "1.5", "3.", ".5", "1.e+", "2.5e3", "99999999999999999999", "1.7976931348623157e309",
+        ":=", ":", "=", "<", "<=", "<>", ">", ">=", "+", "-", "*", "/", "(", ")", ";", ",", ".",
+        "{", "}", "{ comentario }", "{ aberto", "# linha\n", "@", "!", "$", "\"", "'", "\t", "\r\n", "\n",
+        " ", "  ", "\xc3\xa7", "\x7f"};
+
+    std::string randomInput(std::mt19937 &random)
+    {
+        std::uniform_int_distribution<size_t> piece(0, sizeof(PIECES) / sizeof(PIECES[0]) - 1);
+        std::uniform_int_distribution<int> length(1, 40);
+        std::bernoulli_distribution spaced(0.6);
+        std::string text;
+        for (int i = length(random); i > 0; i--)
+        {
+            text += PIECES[piece(random)];
+            if (spaced(random))
+            {
+                text += ' ';
+            }
+        }
+        return text;
+    }
+}
+
+int main()
+{
+    std::ifstream file("tests/fixtures/program.mc");
+    std::ostringstream program;
+    program << file.rdbuf();
+    check(file.good(), "read tests/fixtures/program.mc");
+    compareEngines("fixtures/program.mc", program.str());
+
+    compareEngines("empty", "");
+    compareEngines("only spaces", " \n\t ");
+    compareEngines("unterminated comment", "program p ; { sem fim");
+
+    std::mt19937 random(2024);
+    for (int i = 0; i < 5000; i++)
+    {
+        compareEngines("random input " + std::to_string(i), randomInput(random));
+    }
+
+    return checkResult("TableScannerTest");
+}
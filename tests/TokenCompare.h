@@ -0,0 +1,46 @@
+#ifndef TESTS_TOKEN_COMPARE_H
+#define TESTS_TOKEN_COMPARE_H
+
+#include <vector>
+
+#include "../src/lexical/Diagnostic/Diagnostic.h"
+#include "../src/lexical/TokenBuffer/TokenBuffer.h"
+
+// Igualdade de TokenBuffer (todas as colunas, valores literais inclusive) e
+// de diagnosticos lexicos, para os testes diferenciais do Scanner
+
+inline bool sameTokens(const TokenBuffer &a, const TokenBuffer &b)
+{
+    if (a.kinds != b.kinds || a.keywords != b.keywords || a.offsets != b.offsets || a.lengths != b.lengths ||
+        a.symbols != b.symbols || a.endOffset != b.endOffset || a.literals.size() != b.literals.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.literals.size(); i++)
+    {
+        // Compara os bits: o campo valido depende do tipo do token
+        if (a.literals[i].integer != b.literals[i].integer)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool sameDiagnostics(const std::vector<Diagnostic> &a, const std::vector<Diagnostic> &b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (a[i].offset != b[i].offset || a[i].length != b[i].length || a[i].code != b[i].code)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,21 @@
+#!/bin/sh
+# Compila as fontes do compilador e roda cada tests/*Test.cpp contra elas, a
+# partir da raiz do repositorio. Sai com erro se algum teste falhar.
+#
+#   tests/run.sh                # todos
+#   tests/run.sh EnginesTest    # so os indicados
+set -e
+cd "$(dirname "$0")/.."
+. scripts/objects.sh
+
+if [ $# -eq 0 ]; then
+    set -- $(ls tests/*Test.cpp | sed 's|^tests/||; s|\.cpp$||')
+fi
+
+mkdir -p build/tests
+failed=0
+for test in "$@"; do
+    g++ $FLAGS "tests/$test.cpp" $OBJECTS -pthread -o "build/tests/$test"
+    "build/tests/$test" || failed=1
+done
+exit $failed